@@ -94,13 +94,16 @@ static std::vector<uint64_t> GenerateBlockerBoards(uint64_t mask)
 // Check if a candidate magic number is valid
 static bool IsValidMagic(uint64_t magic, const std::vector<uint64_t>& occupancies, int shift)
 {
+	// The empty occupancy is a valid key, so track used slots separately from their contents
 	std::vector<uint64_t> seen(1ull << shift, 0);
+	std::vector<bool> used(1ull << shift, false);
 	for (uint64_t occupancy : occupancies)
 	{
 		size_t index = (occupancy * magic) >> (64 - shift);
-		if (seen[index] != 0 && seen[index] != occupancy)
+		if (used[index] && seen[index] != occupancy)
 			return false;
 		seen[index] = occupancy;
+		used[index] = true;
 	}
 	return true;
 }
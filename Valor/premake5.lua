@@ -40,3 +40,8 @@ project "Valor"
 		defines "VL_RELEASE"
 		runtime "Release"
 		optimize "on"
+
+	filter "configurations:Dist"
+		defines "VL_DIST"
+		runtime "Release"
+		optimize "on"
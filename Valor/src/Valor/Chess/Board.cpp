@@ -3,11 +3,16 @@
 
 #include "Valor/Chess/MoveGeneration/MagicBitboard.h"
 #include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
+#include "Valor/Core/ZobristHasher.h"
+
+#include <algorithm>
+#include <charconv>
+#include <utility>
 
 namespace Valor {
 
 	Board::Board()
-		: m_IsWhiteTurn(true), m_EnPassantFile(0xff), m_HalfmoveCounter(0)
+		: m_IsWhiteTurn(true), m_EnPassantFile(0xff), m_HalfmoveCounter(0), m_FullmoveNumber(1), m_Hash(0), m_PawnHash(0), m_Material(0), m_GamePhase(0)
 	{
 		Reset();
 	}
@@ -16,6 +21,7 @@ namespace Valor {
 	{
 		m_IsWhiteTurn = true;
 		m_HalfmoveCounter = 0;
+		m_FullmoveNumber = 1;
 		m_EnPassantFile = 0xff;
 
 		m_AllWhite = 0x000000000000FFFFull;
@@ -29,6 +35,306 @@ namespace Valor {
 		m_Kings = 0x1000000000000010ull;
 
 		m_CastlingRights = { true, true, true, true };
+
+		m_Hash = ZobristHasher::Hash(*this);
+		m_PawnHash = ZobristHasher::PawnHash(*this);
+
+		// Both sides' terms cancel out in the starting position
+		m_Material = 0;
+		m_PieceSquareScore = {};
+		m_GamePhase = MaxGamePhase;
+	}
+
+	// Splits the next whitespace separated field off the front of `text`
+	static std::string_view NextField(std::string_view& text)
+	{
+		auto isSpace = [](char c) { return c == ' ' || c == '\t'; };
+
+		size_t begin = 0;
+		while (begin < text.size() && isSpace(text[begin]))
+			begin++;
+		size_t end = begin;
+		while (end < text.size() && !isSpace(text[end]))
+			end++;
+
+		std::string_view field = text.substr(begin, end - begin);
+		text.remove_prefix(end);
+		return field;
+	}
+
+	static PieceType PieceTypeFromChar(char c)
+	{
+		switch (c | 0x20)
+		{
+			case 'p': return PieceType::Pawn;
+			case 'n': return PieceType::Knight;
+			case 'b': return PieceType::Bishop;
+			case 'r': return PieceType::Rook;
+			case 'q': return PieceType::Queen;
+			case 'k': return PieceType::King;
+			default: return PieceType::None;
+		}
+	}
+
+	static bool ParseCounter(std::string_view field, int& value)
+	{
+		auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+		return error == std::errc() && end == field.data() + field.size() && value >= 0;
+	}
+
+	bool Board::FromFEN(std::string_view fen, Board& board)
+	{
+		if (board.ParseFEN(fen))
+			return true;
+
+		board.Reset();
+		return false;
+	}
+
+	bool Board::ParseFEN(std::string_view fen)
+	{
+		std::string_view placement = NextField(fen);
+		std::string_view side = NextField(fen);
+		std::string_view castling = NextField(fen);
+		std::string_view enPassant = NextField(fen);
+		std::string_view halfmove = NextField(fen);
+		std::string_view fullmove = NextField(fen);
+		if (!NextField(fen).empty())
+			return false;
+
+		BeginSetup();
+
+		// Ranks from 8 down to 1, files from a to h
+		int rank = 7, file = 0;
+		for (char c : placement)
+		{
+			if (c == '/')
+			{
+				if (file != 8 || --rank < 0)
+					return false;
+				file = 0;
+			}
+			else if (c >= '1' && c <= '8')
+			{
+				file += c - '0';
+				if (file > 8)
+					return false;
+			}
+			else
+			{
+				PieceType type = PieceTypeFromChar(c);
+				if (type == PieceType::None || file > 7)
+					return false;
+
+				SetupPiece(Tile((uint8_t)rank, (uint8_t)file), c < 'a' ? PieceColor::White : PieceColor::Black, type);
+				file++;
+			}
+		}
+
+		if (rank != 0 || file != 8)
+			return false;
+
+		if (side != "w" && side != "b")
+			return false;
+		m_IsWhiteTurn = side == "w";
+
+		m_CastlingRights = { false, false, false, false };
+		if (castling != "-")
+		{
+			for (char c : castling)
+			{
+				size_t right = std::string_view("QKqk").find(c);
+				if (right == std::string_view::npos)
+					return false;
+				m_CastlingRights[right] = true;
+			}
+		}
+
+		m_EnPassantFile = 0xff;
+		if (enPassant != "-")
+		{
+			if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] != (m_IsWhiteTurn ? '6' : '3'))
+				return false;
+			m_EnPassantFile = (uint8_t)(enPassant[0] - 'a');
+		}
+
+		int halfmoveCounter = 0, fullmoveNumber = 1;
+		if (!halfmove.empty() && !ParseCounter(halfmove, halfmoveCounter))
+			return false;
+		if (!fullmove.empty() && !ParseCounter(fullmove, fullmoveNumber))
+			return false;
+		m_HalfmoveCounter = (uint8_t)std::min(halfmoveCounter, 255);
+		m_FullmoveNumber = (uint16_t)std::clamp(fullmoveNumber, 1, 65535);
+
+		return FinishSetup();
+	}
+
+	bool Board::FromPacked(const PackedBoard& packed, Board& board)
+	{
+		if (board.Unpack(packed))
+			return true;
+
+		board.Reset();
+		return false;
+	}
+
+	bool Board::Unpack(const PackedBoard& packed)
+	{
+		if (std::popcount(packed.Occupancy) > 32 || (packed.EnPassantFile > 7 && packed.EnPassantFile != 0xff))
+			return false;
+
+		BeginSetup();
+
+		int index = 0;
+		for (uint64_t occupied = packed.Occupancy; occupied; occupied &= occupied - 1, index++)
+		{
+			int code = (packed.Pieces[index / 2] >> (index % 2 * 4)) & 0xf;
+			if ((code & 7) > (int)PieceType::King)
+				return false;
+
+			SetupPiece(Tile((uint8_t)std::countr_zero(occupied)), (code & 8) ? PieceColor::Black : PieceColor::White, (PieceType)(code & 7));
+		}
+
+		m_IsWhiteTurn = !(packed.State & 1);
+		for (int i = 0; i < 4; i++)
+			m_CastlingRights[i] = (packed.State >> (i + 1)) & 1;
+		m_EnPassantFile = packed.EnPassantFile;
+		m_HalfmoveCounter = packed.HalfmoveCounter;
+		m_FullmoveNumber = std::max<uint16_t>(packed.FullmoveNumber, 1);
+
+		return FinishSetup();
+	}
+
+	bool Board::ToPacked(PackedBoard& packed) const
+	{
+		packed = PackedBoard();
+
+		uint64_t occupied = Occupied();
+		if (std::popcount(occupied) > 32)
+			return false;
+
+		// A piece's place in the list is the number of occupied squares below it
+		packed.Occupancy = occupied;
+		const uint64_t pieceBitboards[6] = { m_Pawns, m_Knights, m_Bishops, m_Rooks, m_Queens, m_Kings };
+		for (int type = 0; type < 6; type++)
+		{
+			for (uint64_t pieces = pieceBitboards[type]; pieces; pieces &= pieces - 1)
+			{
+				uint64_t bit = pieces & (0 - pieces);
+				int index = std::popcount(occupied & (bit - 1));
+				int code = type | ((m_AllBlack & bit) ? 8 : 0);
+				packed.Pieces[index / 2] |= (uint8_t)(code << (index % 2 * 4));
+			}
+		}
+
+		packed.State = m_IsWhiteTurn ? 0 : 1;
+		for (int i = 0; i < 4; i++)
+			packed.State |= (uint8_t)(m_CastlingRights[i] << (i + 1));
+		packed.EnPassantFile = m_EnPassantFile;
+		packed.HalfmoveCounter = m_HalfmoveCounter;
+		packed.FullmoveNumber = m_FullmoveNumber;
+		return true;
+	}
+
+	void Board::BeginSetup()
+	{
+		m_AllWhite = m_AllBlack = 0;
+		m_Pawns = m_Knights = m_Bishops = m_Rooks = m_Queens = m_Kings = 0;
+		m_Material = 0;
+		m_PieceSquareScore = {};
+		m_GamePhase = 0;
+	}
+
+	void Board::SetupPiece(Tile tile, PieceColor color, PieceType type)
+	{
+		uint64_t* const pieceBitboards[6] = { &m_Pawns, &m_Knights, &m_Bishops, &m_Rooks, &m_Queens, &m_Kings };
+		(color == PieceColor::White ? m_AllWhite : m_AllBlack) |= 1ULL << tile;
+		*pieceBitboards[(int)type] |= 1ULL << tile;
+
+		const PieceSquareEntry& entry = PieceSquareTables::Get(type, color, tile);
+		m_Material += entry.Material;
+		m_PieceSquareScore += entry.Bonus;
+		m_GamePhase += entry.Phase;
+	}
+
+	bool Board::FinishSetup()
+	{
+		constexpr uint64_t BackRanks = 0xFF000000000000FFull;
+		if ((m_Pawns & BackRanks) || std::popcount(Kings(true)) != 1 || std::popcount(Kings(false)) != 1)
+			return false;
+
+		bool whiteKingHome = (Kings(true) >> Tiles::E1) & 1;
+		bool blackKingHome = (Kings(false) >> Tiles::E8) & 1;
+		m_CastlingRights[0] &= whiteKingHome && ((Rooks(true) >> Tiles::A1) & 1);
+		m_CastlingRights[1] &= whiteKingHome && ((Rooks(true) >> Tiles::H1) & 1);
+		m_CastlingRights[2] &= blackKingHome && ((Rooks(false) >> Tiles::A8) & 1);
+		m_CastlingRights[3] &= blackKingHome && ((Rooks(false) >> Tiles::H8) & 1);
+
+		m_Hash = ZobristHasher::Hash(*this);
+		m_PawnHash = ZobristHasher::PawnHash(*this);
+		return true;
+	}
+
+	std::string_view Board::ToFEN(std::span<char, MaxFENLength> buffer) const
+	{
+		char* out = buffer.data();
+		for (int rank = 7; rank >= 0; rank--)
+		{
+			int empty = 0;
+			for (int file = 0; file < 8; file++)
+			{
+				Piece piece = GetPiece(rank, file);
+				if (piece.Type == PieceType::None)
+				{
+					empty++;
+					continue;
+				}
+
+				if (empty)
+					*out++ = (char)('0' + std::exchange(empty, 0));
+				*out++ = piece.Color == PieceColor::White ? piece.ToChar() : (char)(piece.ToChar() | 0x20);
+			}
+
+			if (empty)
+				*out++ = (char)('0' + empty);
+			if (rank > 0)
+				*out++ = '/';
+		}
+
+		*out++ = ' ';
+		*out++ = m_IsWhiteTurn ? 'w' : 'b';
+
+		*out++ = ' ';
+		const char* castling = out;
+		if (CanCastle(true, true)) *out++ = 'K';
+		if (CanCastle(true, false)) *out++ = 'Q';
+		if (CanCastle(false, true)) *out++ = 'k';
+		if (CanCastle(false, false)) *out++ = 'q';
+		if (out == castling)
+			*out++ = '-';
+
+		*out++ = ' ';
+		if (m_EnPassantFile != 0xff)
+		{
+			*out++ = (char)('a' + m_EnPassantFile);
+			*out++ = m_IsWhiteTurn ? '6' : '3';
+		}
+		else
+			*out++ = '-';
+
+		char* end = buffer.data() + buffer.size();
+		*out++ = ' ';
+		out = std::to_chars(out, end, m_HalfmoveCounter).ptr;
+		*out++ = ' ';
+		out = std::to_chars(out, end, m_FullmoveNumber).ptr;
+
+		return { buffer.data(), (size_t)(out - buffer.data()) };
+	}
+
+	std::string Board::ToFEN() const
+	{
+		std::array<char, MaxFENLength> buffer;
+		return std::string(ToFEN(buffer));
 	}
 
 	MoveInfo Board::ParseMove(Tile source, Tile target) const
@@ -91,6 +397,168 @@ namespace Valor {
 		return move;
 	}
 
+	// True if moving from `source` to `target` and taking the `captured` pieces leaves the mover's king safe
+	static bool LeavesKingSafe(const Board& board, Tile source, Tile target, uint64_t captured)
+	{
+		uint64_t sourceBit = 1ULL << source;
+		uint64_t occupancy = (board.Occupied() & ~sourceBit & ~captured) | (1ULL << target);
+		Tile kingSquare = (board.Kings() & sourceBit) ? target : Tile((uint8_t)board.GetKingSquare(board.IsWhiteTurn()));
+		return !(board.AttackersTo(kingSquare, occupancy) & board.OpponentPieces() & ~captured);
+	}
+
+	static Move ParseCastling(const Board& board, bool kingSide)
+	{
+		bool isWhite = board.IsWhiteTurn();
+		uint8_t rank = isWhite ? 0 : 7;
+		Tile source(rank, 4);
+		Tile target(rank, kingSide ? 6 : 2);
+
+		// The squares between king and rook must be empty, and the king may not start on, cross or land on an attacked one
+		uint64_t between = (kingSide ? 0x60ULL : 0x0eULL) << (rank * 8);
+		if (!board.CanCastle(isWhite, kingSide) || !(board.Kings(isWhite) & (1ULL << source)) || (board.Occupied() & between))
+			return Move();
+
+		int step = kingSide ? 1 : -1;
+		for (int file = 4; file != target.GetFile() + step; file += step)
+		{
+			if (board.IsSquareAttacked(Tile(rank, (uint8_t)file), isWhite))
+				return Move();
+		}
+		return Move(source, target, PieceType::King, MoveFlags::Castling);
+	}
+
+	Move Board::ParseSAN(std::string_view san) const
+	{
+		// Check marks and annotations add nothing to the move
+		while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+			san.remove_suffix(1);
+
+		if (san == "O-O" || san == "0-0")
+			return ParseCastling(*this, true);
+		if (san == "O-O-O" || san == "0-0-0")
+			return ParseCastling(*this, false);
+
+		// Promotions end with the piece, as in e8=Q or e8Q
+		PieceType promotion = PieceType::None;
+		if (san.size() > 2 && (san.back() < '1' || san.back() > '8'))
+		{
+			promotion = PieceTypeFromChar(san.back());
+			if (promotion == PieceType::None || promotion == PieceType::Pawn || promotion == PieceType::King)
+				return Move();
+
+			san.remove_suffix(1);
+			if (san.back() == '=')
+				san.remove_suffix(1);
+		}
+
+		if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' || san.back() > '8')
+			return Move();
+		Tile target((uint8_t)(san.back() - '1'), (uint8_t)(san[san.size() - 2] - 'a'));
+		san.remove_suffix(2);
+
+		// An uppercase piece letter, then whatever tells the moving piece apart: its file, its rank or both
+		PieceType pieceType = PieceType::Pawn;
+		if (!san.empty() && san[0] >= 'A' && san[0] <= 'Z')
+		{
+			pieceType = PieceTypeFromChar(san[0]);
+			if (pieceType == PieceType::None)
+				return Move();
+			san.remove_prefix(1);
+		}
+
+		uint64_t sourceMask = ~0ULL;
+		for (char c : san)
+		{
+			if (c >= 'a' && c <= 'h')
+				sourceMask &= FileA << (c - 'a');
+			else if (c >= '1' && c <= '8')
+				sourceMask &= 0xffULL << ((c - '1') * 8);
+			else if (c != 'x' && c != '-')
+				return Move();
+		}
+
+		uint64_t targetBit = 1ULL << target;
+		if (PlayerPieces() & targetBit)
+			return Move();
+
+		uint64_t captured = OpponentPieces() & targetBit;
+		bool isPromotionRank = target.GetRank() == (m_IsWhiteTurn ? 7 : 0);
+		if (promotion != PieceType::None && (pieceType != PieceType::Pawn || !isPromotionRank))
+			return Move();
+
+		// Pieces that could reach the target, found by looking back from it
+		uint64_t candidates = 0;
+		uint64_t enPassantCapture = 0;
+		switch (pieceType)
+		{
+		case PieceType::Pawn:
+		{
+			uint64_t pawns = Pawns(m_IsWhiteTurn);
+			int forward = m_IsWhiteTurn ? 8 : -8;
+			int single = target - forward;
+			if (!captured && single >= 0 && single < 64)
+			{
+				if (pawns & (1ULL << single))
+					candidates |= 1ULL << single;
+				else if (target.GetRank() == (m_IsWhiteTurn ? 3 : 4) && !IsOccupied(Tile((uint8_t)single)))
+					candidates |= pawns & (1ULL << (single - forward));
+			}
+
+			// A capture names the pawn's file, so a bare square is always a push
+			if (sourceMask != ~0ULL)
+			{
+				bool isEnPassant = !captured && target.GetFile() == m_EnPassantFile && target.GetRank() == (m_IsWhiteTurn ? 5 : 2);
+				if (isEnPassant)
+					enPassantCapture = 1ULL << single;
+				if (captured || isEnPassant)
+					candidates |= (m_IsWhiteTurn ? MagicBitboard::GetBlackPawnAttacks(target) : MagicBitboard::GetWhitePawnAttacks(target)) & pawns;
+			}
+
+			if (isPromotionRank && promotion == PieceType::None)
+				promotion = PieceType::Queen;
+			break;
+		}
+		case PieceType::Knight:
+			candidates = MagicBitboard::GetKnightAttacks(target) & Knights(m_IsWhiteTurn);
+			break;
+		case PieceType::Bishop:
+			candidates = MagicBitboard::GetBishopAttacks(target, Occupied()) & Bishops(m_IsWhiteTurn);
+			break;
+		case PieceType::Rook:
+			candidates = MagicBitboard::GetRookAttacks(target, Occupied()) & Rooks(m_IsWhiteTurn);
+			break;
+		case PieceType::Queen:
+			candidates = (MagicBitboard::GetBishopAttacks(target, Occupied()) | MagicBitboard::GetRookAttacks(target, Occupied())) & Queens(m_IsWhiteTurn);
+			break;
+		case PieceType::King:
+			candidates = MagicBitboard::GetKingAttacks(target) & Kings(m_IsWhiteTurn);
+			break;
+		default:
+			return Move();
+		}
+		candidates &= sourceMask;
+
+		// Exactly one of them may move there without leaving its king in check
+		Move move;
+		for (; candidates; candidates &= candidates - 1)
+		{
+			Tile source((uint8_t)std::countr_zero(candidates));
+			bool isEnPassant = enPassantCapture && source.GetFile() != target.GetFile();
+			if (!LeavesKingSafe(*this, source, target, isEnPassant ? enPassantCapture : captured))
+				continue;
+			if (move.IsValid())
+				return Move();
+
+			uint8_t flags = (captured || isEnPassant) ? MoveFlags::Capture : 0;
+			if (isEnPassant)
+				flags |= MoveFlags::EnPassant;
+			if (promotion != PieceType::None)
+				flags |= MoveFlags::Promotion;
+			move = Move(source, target, pieceType, flags, promotion);
+		}
+		return move;
+	}
+
 	void Board::MakeMove(Move move)
 	{
 		uint64_t sourceBit = 1ULL << move.Source;
@@ -102,8 +570,12 @@ namespace Valor {
 		Piece capturedPiece = GetPiece(move.Target);
 
 		// Update castling rights
+		m_Hash ^= CastlingHash();
 		UpdateCastlingRights(move.Source, move.Target);
-		m_HalfmoveCounter = (move.IsCapture() || piece.Type == PieceType::Pawn) ? 0 : m_HalfmoveCounter + 1;
+		m_Hash ^= CastlingHash();
+
+		// Captures aren't always flagged, so look at the target square
+		m_HalfmoveCounter = (capturedPiece.Type != PieceType::None || piece.Type == PieceType::Pawn) ? 0 : m_HalfmoveCounter + 1;
 
 		// Move the piece
 		RemovePiece(move.Source);
@@ -148,17 +620,39 @@ namespace Valor {
 		}
 
 		// Update en passant target square
+		if (m_EnPassantFile != 0xFF)
+			m_Hash ^= ZobristHasher::GetEnPassantKey(m_EnPassantFile);
+
 		if (piece.Type == PieceType::Pawn && std::abs(move.Source.GetRank() - move.Target.GetRank()) == 2) {
 			m_EnPassantFile = move.Target.GetFile();
+			m_Hash ^= ZobristHasher::GetEnPassantKey(m_EnPassantFile);
 		}
 		else {
 			m_EnPassantFile = 0xFF; // No en passant available
 		}
 
 		// Toggle turn
+		if (!m_IsWhiteTurn)
+			m_FullmoveNumber++;
+		ToggleTurn();
+	}
+
+	void Board::MakeNullMove()
+	{
+		if (m_EnPassantFile != 0xFF)
+			m_Hash ^= ZobristHasher::GetEnPassantKey(m_EnPassantFile);
+
+		m_EnPassantFile = 0xFF;
+		m_HalfmoveCounter++;
 		ToggleTurn();
 	}
 
+	void Board::ToggleTurn()
+	{
+		m_IsWhiteTurn ^= 1;
+		m_Hash ^= ZobristHasher::GetSideKey();
+	}
+
 	bool Board::IsAmbiguousMove(Tile source, Tile target, PieceType pieceType) const
 	{
 		uint64_t occupancy = Occupied();
@@ -247,6 +741,19 @@ namespace Valor {
 
 	void Board::RemovePiece(Tile tile)
 	{
+		if (!IsOccupied(tile))
+			return;
+
+		Piece piece = GetPiece(tile);
+		m_Hash ^= ZobristHasher::GetPieceKey(piece.Type, piece.Color, tile);
+		if (piece.Type == PieceType::Pawn)
+			m_PawnHash ^= ZobristHasher::GetPieceKey(piece.Type, piece.Color, tile);
+
+		const PieceSquareEntry& entry = PieceSquareTables::Get(piece.Type, piece.Color, tile);
+		m_Material -= entry.Material;
+		m_PieceSquareScore -= entry.Bonus;
+		m_GamePhase -= entry.Phase;
+
 		uint64_t mask = ~(1ULL << tile);
 		m_AllWhite &= mask;
 		m_AllBlack &= mask;
@@ -277,27 +784,45 @@ namespace Valor {
 			case PieceType::Queen:  m_Queens |= bit; break;
 			case PieceType::King:   m_Kings |= bit; break;
 		}
+
+		m_Hash ^= ZobristHasher::GetPieceKey(type, color, tile);
+		if (type == PieceType::Pawn)
+			m_PawnHash ^= ZobristHasher::GetPieceKey(type, color, tile);
+
+		const PieceSquareEntry& entry = PieceSquareTables::Get(type, color, tile);
+		m_Material += entry.Material;
+		m_PieceSquareScore += entry.Bonus;
+		m_GamePhase += entry.Phase;
 	}
 
 	void Board::UpdateCastlingRights(Tile source, Tile target)
 	{
-		if (source == Tiles::E1 || source == Tiles::E8)
-		{
-			m_CastlingRights[m_IsWhiteTurn ? 0 : 2] = false; // Queen-side
-			m_CastlingRights[m_IsWhiteTurn ? 1 : 3] = false; // King-side
-		}
+		// Checked one by one, since a move can leave one home square and land on another, like Rxa8 from a1
+		if (source == Tiles::E1) // King moves
+			m_CastlingRights[0] = m_CastlingRights[1] = false;
+		if (source == Tiles::E8)
+			m_CastlingRights[2] = m_CastlingRights[3] = false;
 
-		else if (source == Tiles::A1 || target == Tiles::A1) // Rook moves (white queen-side)
+		if (source == Tiles::A1 || target == Tiles::A1) // Rook moves or is captured (white queen-side)
 			m_CastlingRights[0] = false;
-		else if (source == Tiles::H1 || target == Tiles::H1) // Rook moves (white king-side)
+		if (source == Tiles::H1 || target == Tiles::H1) // Rook moves or is captured (white king-side)
 			m_CastlingRights[1] = false;
 
-		else if (source == Tiles::A8 || target == Tiles::A8) // Rook moves (black queen-side)
+		if (source == Tiles::A8 || target == Tiles::A8) // Rook moves or is captured (black queen-side)
 			m_CastlingRights[2] = false;
-		else if (source == Tiles::H8 || target == Tiles::H8) // Rook moves (black king-side)
+		if (source == Tiles::H8 || target == Tiles::H8) // Rook moves or is captured (black king-side)
 			m_CastlingRights[3] = false;
 	}
 
+	uint64_t Board::CastlingHash() const
+	{
+		uint64_t hash = 0;
+		for (int i = 0; i < 4; ++i)
+			if (m_CastlingRights[i])
+				hash ^= ZobristHasher::GetCastlingKey(i);
+		return hash;
+	}
+
 	bool Board::IsInsufficientMaterial() const
 	{
 		int whitePieces = std::popcount(m_AllWhite);
@@ -428,4 +953,14 @@ namespace Valor {
 		return false;
 	}
 
+	uint64_t Board::AttackersTo(Tile square, uint64_t occupancy) const
+	{
+		return (MagicBitboard::GetBlackPawnAttacks(square) & m_Pawns & m_AllWhite)
+			| (MagicBitboard::GetWhitePawnAttacks(square) & m_Pawns & m_AllBlack)
+			| (MagicBitboard::GetKnightAttacks(square) & m_Knights)
+			| (MagicBitboard::GetKingAttacks(square) & m_Kings)
+			| (MagicBitboard::GetBishopAttacks(square, occupancy) & (m_Bishops | m_Queens))
+			| (MagicBitboard::GetRookAttacks(square, occupancy) & (m_Rooks | m_Queens));
+	}
+
 }
@@ -3,11 +3,16 @@
 
 #include "Valor/Chess/Tile.h"
 #include "Valor/Chess/Move.h"
+#include "Valor/Chess/PackedBoard.h"
+#include "Valor/Chess/PieceSquareTables.h"
 
 #include <cstdint>
 #include <ostream>
 #include <array>
 #include <bit>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace Valor {
@@ -15,15 +20,44 @@ namespace Valor {
 	struct Board
 	{
 	public:
+		// Longest FEN `ToFEN` writes
+		constexpr static size_t MaxFENLength = 96;
+
 		Board();
 		Board(const Board& other) = default;
 		~Board() = default;
 
 		void Reset();
 
+		// Sets up the position of a FEN. The move counters may be left out, as EPD does. Doesn't allocate.
+		// Returns false if the FEN is malformed or either side doesn't have exactly one king, and leaves the
+		// board in the starting position.
+		static bool FromFEN(std::string_view fen, Board& board);
+
+		// Writes the position as a FEN into `buffer`, without a terminating null, and returns the part written
+		std::string_view ToFEN(std::span<char, MaxFENLength> buffer) const;
+		std::string ToFEN() const;
+
+		// Sets up a packed position, checked like a FEN. Returns false if it isn't valid, and leaves the board in
+		// the starting position.
+		static bool FromPacked(const PackedBoard& packed, Board& board);
+
+		// Returns false if the position has more than 32 pieces
+		bool ToPacked(PackedBoard& packed) const;
+
 		MoveInfo ParseMove(Tile source, Tile target) const;
+
+		// Finds the move written in standard algebraic notation, like Nbd7, exd6, e8=Q+ or O-O, from the pieces
+		// attacking its target square rather than by generating moves. Returns an invalid move if the SAN is
+		// malformed or doesn't name exactly one legal move. A pawn reaching the last rank without a piece
+		// promotes to a queen.
+		Move ParseSAN(std::string_view san) const;
+
 		void MakeMove(Move move);
 
+		// Passes the turn without moving, used by null move pruning
+		void MakeNullMove();
+
 		bool IsAmbiguousMove(Tile source, Tile target, PieceType pieceType) const;
 		void ResolveDisambiguity(Tile source, Tile target, PieceType pieceType, uint8_t& disambiguityRank, uint8_t& disambiguityFile) const;
 
@@ -31,15 +65,27 @@ namespace Valor {
 		void PlacePiece(Tile tile, PieceColor color, PieceType type);
 
 		bool IsWhiteTurn() const { return m_IsWhiteTurn; }
-		void ToggleTurn() { m_IsWhiteTurn ^= 1; }
+		void ToggleTurn();
 
 		void UpdateCastlingRights(Tile source, Tile target);
 		bool IsFiftyMoveRule() const { return m_HalfmoveCounter >= 100; }
+		uint8_t GetHalfmoveCounter() const { return m_HalfmoveCounter; }
+		uint16_t GetFullmoveNumber() const { return m_FullmoveNumber; }
 		bool IsInsufficientMaterial() const;
 
 		uint8_t GetEnPassantFile() const { return m_EnPassantFile; }
 		bool CanCastle(bool isWhite, bool kingSide) const { return m_CastlingRights[(isWhite ? 0ull : 2ull) + kingSide]; }
 
+		// Zobrist key of the position, kept up to date by every change to the board
+		uint64_t GetHash() const { return m_Hash; }
+		// Key of the pawns alone, kept up to date the same way
+		uint64_t GetPawnHash() const { return m_PawnHash; }
+
+		// Running evaluation terms, White minus Black, kept up to date the same way
+		int GetMaterial() const { return m_Material; }
+		const TaperedScore& GetPieceSquareScore() const { return m_PieceSquareScore; }
+		int GetGamePhase() const { return m_GamePhase; }
+
 		Piece GetPiece(Tile tile) const;
 		Piece GetPiece(int rank, int file) const { return GetPiece(Tile(rank, file)); }
 
@@ -78,9 +124,23 @@ namespace Valor {
 
 		bool IsLegalMove(Move move) const;
 		bool IsSquareAttacked(Tile square, bool isWhite) const;
+
+		// Pieces of both colors attacking `square`, with sliders seen through `occupancy`
+		uint64_t AttackersTo(Tile square, uint64_t occupancy) const;
 	public:
 		constexpr static uint64_t FileA = 0x0101010101010101ull;
 		constexpr static uint64_t FileH = 0x8080808080808080ull;
+	private:
+		uint64_t CastlingHash() const;
+		bool ParseFEN(std::string_view fen);
+		bool Unpack(const PackedBoard& packed);
+
+		// Setting up a position from scratch: pieces are added without updating the keys, which are computed once
+		// by `FinishSetup`. It also drops castling rights whose king or rook isn't at home any more, as some FEN
+		// writers leave them in, and returns false unless each side has one king and no pawn is on a back rank.
+		void BeginSetup();
+		void SetupPiece(Tile tile, PieceColor color, PieceType type);
+		bool FinishSetup();
 	private:
 		uint64_t m_AllWhite, m_AllBlack;
 		uint64_t m_Pawns, m_Knights, m_Bishops, m_Rooks, m_Queens, m_Kings;
@@ -90,6 +150,13 @@ namespace Valor {
 		std::array<bool, 4> m_CastlingRights;  // [white/black][king/queen]
 
 		uint8_t m_HalfmoveCounter;
+		uint16_t m_FullmoveNumber;
+		uint64_t m_Hash;
+		uint64_t m_PawnHash;
+
+		int m_Material;
+		TaperedScore m_PieceSquareScore;
+		int m_GamePhase;
 	};
 
 };
@@ -0,0 +1,182 @@
+#include "vlpch.h"
+#include "Valor/Chess/EPDReader.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace Valor {
+
+	// Plain loops, the character set searches of string_view cost more than the rest of a line's parsing
+	static bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	static std::string_view TrimFront(std::string_view text)
+	{
+		size_t begin = 0;
+		while (begin < text.size() && IsSpace(text[begin]))
+			begin++;
+		return text.substr(begin);
+	}
+
+	static std::string_view TrimBack(std::string_view text)
+	{
+		size_t end = text.size();
+		while (end > 0 && IsSpace(text[end - 1]))
+			end--;
+		return text.substr(0, end);
+	}
+
+	// Offset just past the field starting at or after `offset`
+	static size_t SkipField(std::string_view line, size_t offset)
+	{
+		while (offset < line.size() && IsSpace(line[offset]))
+			offset++;
+		while (offset < line.size() && !IsSpace(line[offset]))
+			offset++;
+		return offset;
+	}
+
+	static bool IsCounter(std::string_view field)
+	{
+		return !field.empty() && std::all_of(field.begin(), field.end(), [](char c) { return c >= '0' && c <= '9'; });
+	}
+
+	// The position is the first four fields, with the two move counters after them if it's a FEN
+	static bool ParseLine(std::string_view line, EPDRecord& record)
+	{
+		size_t end = 0;
+		for (int i = 0; i < 4; i++)
+			end = SkipField(line, end);
+
+		for (int i = 0; i < 2; i++)
+		{
+			size_t next = SkipField(line, end);
+			if (!IsCounter(TrimFront(line.substr(end, next - end))))
+				break;
+			end = next;
+		}
+
+		if (!Board::FromFEN(line.substr(0, end), record.Position))
+			return false;
+
+		record.Line = line;
+		record.Operations = TrimBack(TrimFront(line.substr(end)));
+		return true;
+	}
+
+	std::optional<EPDOperation> EPDRecord::FindOperation(std::string_view opcode) const
+	{
+		std::string_view operations = Operations;
+		EPDOperation operation;
+		while (NextOperation(operations, operation))
+		{
+			if (operation.Opcode == opcode)
+				return operation;
+		}
+		return std::nullopt;
+	}
+
+	int EPDRecord::GetResult() const
+	{
+		if (Operations.find("1/2-1/2") != std::string_view::npos) return 1;
+		if (Operations.find("1-0") != std::string_view::npos) return 2;
+		if (Operations.find("0-1") != std::string_view::npos) return 0;
+
+		size_t open = Operations.rfind('[');
+		if (open == std::string_view::npos)
+			return -1;
+
+		double result;
+		auto [end, error] = std::from_chars(Operations.data() + open + 1, Operations.data() + Operations.size(), result);
+		if (error != std::errc() || end == Operations.data() + Operations.size() || *end != ']')
+			return -1;
+		return std::clamp((int)(result * 2 + 0.5), 0, 2);
+	}
+
+	bool EPDRecord::NextOperation(std::string_view& operations, EPDOperation& operation)
+	{
+		while (true)
+		{
+			operations = TrimFront(operations);
+			if (operations.empty())
+				return false;
+
+			// An operation ends at the first semicolon outside quotes, or with the line
+			size_t end = 0;
+			bool isQuoted = false;
+			for (; end < operations.size() && (isQuoted || operations[end] != ';'); end++)
+			{
+				if (operations[end] == '"')
+					isQuoted = !isQuoted;
+			}
+
+			std::string_view text = TrimBack(operations.substr(0, end));
+			operations.remove_prefix(std::min(end + 1, operations.size()));
+			if (text.empty())
+				continue;
+
+			size_t opcodeEnd = SkipField(text, 0);
+			operation.Opcode = text.substr(0, opcodeEnd);
+			operation.Operands = TrimFront(text.substr(opcodeEnd));
+			return true;
+		}
+	}
+
+	bool EPDReader::Next(EPDRecord& record)
+	{
+		while (!m_Text.empty())
+		{
+			const char* newline = static_cast<const char*>(std::memchr(m_Text.data(), '\n', m_Text.size()));
+			size_t end = newline ? (size_t)(newline - m_Text.data()) : m_Text.size();
+
+			std::string_view line = m_Text.substr(0, end);
+			m_Text.remove_prefix(std::min(end + 1, m_Text.size()));
+
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+			if (TrimFront(line).empty())
+				continue;
+
+			if (ParseLine(line, record))
+				return true;
+			m_SkippedLines++;
+		}
+		return false;
+	}
+
+	bool EPDFile::Open(const std::string& path)
+	{
+		if (!m_File.Open(path, MappedFile::Access::Sequential))
+		{
+			std::cerr << "Could not open EPD file " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<std::string_view> EPDFile::Split(size_t count) const
+	{
+		std::string_view text = GetText();
+		count = std::max<size_t>(count, 1);
+
+		std::vector<std::string_view> ranges;
+		size_t begin = 0;
+		for (size_t i = 1; i <= count && begin < text.size(); i++)
+		{
+			// Each range ends with the line that holds its share of the bytes
+			size_t end = text.size();
+			if (i < count)
+			{
+				size_t target = std::max(begin, text.size() * i / count);
+				end = std::min(text.find('\n', target), text.size() - 1) + 1;
+			}
+
+			ranges.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+		return ranges;
+	}
+
+}
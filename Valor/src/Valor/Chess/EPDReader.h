@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Valor {
+
+	// One operation of an EPD record, such as `bm Nf3;` or `c9 "1-0";`. The operands are as written, quotes included.
+	struct EPDOperation
+	{
+		std::string_view Opcode;
+		std::string_view Operands;
+	};
+
+	// A position read from EPD text. The views point into the text.
+	struct EPDRecord
+	{
+		Board Position;
+		std::string_view Line;
+
+		// The rest of the line after the position: its operations, or whatever else the line carries, like
+		// a result in brackets
+		std::string_view Operations;
+
+		std::optional<EPDOperation> FindOperation(std::string_view opcode) const;
+
+		// Game result written after the position as "1-0", "0-1" or "1/2-1/2", or as [1.0], [0.5] or [0.0], in
+		// half points for White. -1 if there's none.
+		int GetResult() const;
+
+		// Splits the first operation off `operations`. Returns false once there are none left.
+		static bool NextOperation(std::string_view& operations, EPDOperation& operation);
+	};
+
+	// Reads EPD text a line at a time, without copying it. Also reads FENs, and lines that follow a FEN
+	// with operations. Blank lines are passed over; lines whose position doesn't parse are skipped and counted.
+	class EPDReader
+	{
+	public:
+		explicit EPDReader(std::string_view text) : m_Text(text) {}
+
+		// Reads the next position into `record`. Returns false at the end of the text.
+		bool Next(EPDRecord& record);
+
+		size_t GetSkippedLines() const { return m_SkippedLines; }
+	private:
+		std::string_view m_Text;
+		size_t m_SkippedLines = 0;
+	};
+
+	// An EPD file mapped into memory, so files of any size are read without loading them first
+	class EPDFile
+	{
+	public:
+		// Returns false if the file can't be mapped
+		bool Open(const std::string& path);
+		void Close() { m_File.Close(); }
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+		std::string_view GetText() const { return { reinterpret_cast<const char*>(m_File.GetData()), m_File.GetSize() }; }
+
+		// Up to `count` ranges of whole lines of about the same size, covering the file in order
+		std::vector<std::string_view> Split(size_t count) const;
+
+		// Reads the file on up to `threadCount` threads, each reading one range from `Split`, and calls
+		// `callback(record, threadIndex)` for every position. Calls from different threads run at the same
+		// time. Returns the number of skipped lines.
+		template<typename TCallback>
+		size_t ReadParallel(unsigned threadCount, TCallback&& callback) const
+		{
+			std::vector<std::string_view> ranges = Split(std::max(threadCount, 1u));
+			std::vector<size_t> skippedLines(ranges.size());
+
+			std::vector<std::thread> threads;
+			for (unsigned i = 0; i < ranges.size(); i++)
+			{
+				threads.emplace_back([&, i]()
+				{
+					EPDReader reader(ranges[i]);
+					EPDRecord record;
+					while (reader.Next(record))
+						callback(record, i);
+					skippedLines[i] = reader.GetSkippedLines();
+				});
+			}
+
+			for (std::thread& thread : threads)
+				thread.join();
+
+			return std::accumulate(skippedLines.begin(), skippedLines.end(), size_t(0));
+		}
+	private:
+		MappedFile m_File;
+	};
+
+}
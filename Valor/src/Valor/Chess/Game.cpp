@@ -17,21 +17,17 @@ namespace Valor {
 	{
 		m_Board.Reset();
 		m_MoveHistory.clear();
-		m_BoardHistoryHashes.clear();
 		m_BoardHistory.clear();
+		m_HashHistory.clear();
 	}
 
 	void Game::MakeMove(Move move)
 	{
 		m_MoveHistory.emplace_back(move);
 		m_BoardHistory.emplace_back(m_Board);
+		m_HashHistory.emplace_back(m_Board.GetHash());
 
 		m_Board.MakeMove(move);
-
-		// Update the board history hash
-		// TODO
-//		size_t hash = m_Board.Hash();
-//		m_BoardHistoryHashes[hash]++;
 	}
 
 	void Game::UndoMove()
@@ -39,17 +35,24 @@ namespace Valor {
 		if (m_BoardHistory.empty())
 			return;
 
-		// TODO: Update board history hash
 		m_Board = m_BoardHistory.back();
 
 		m_BoardHistory.pop_back();
+		m_HashHistory.pop_back();
 		m_MoveHistory.pop_back();
 	}
 
 	bool Game::IsThreefoldRepetition() const
 	{
-		return std::any_of(m_BoardHistoryHashes.begin(), m_BoardHistoryHashes.end(),
-			[](const std::pair<size_t, int>& pair) { return pair.second >= 3; });
+		// Only positions since the last capture or pawn move can repeat, and only with the same side to move
+		int distance = std::min<int>(m_Board.GetHalfmoveCounter(), static_cast<int>(m_HashHistory.size()));
+		int repetitions = 0;
+
+		for (int i = 2; i <= distance; i += 2)
+			if (m_HashHistory[m_HashHistory.size() - i] == m_Board.GetHash() && ++repetitions == 2)
+				return true;
+
+		return false;
 	}
 
 }
@@ -4,7 +4,8 @@
 #include "Valor/Chess/Move.h"
 
 #include <deque>
-#include <unordered_map>
+#include <span>
+#include <vector>
 
 namespace Valor {
 
@@ -26,11 +27,14 @@ namespace Valor {
 
 		// Getters
 		const Board& GetBoard() const { return m_Board; }
+
+		// Zobrist keys of every position before the current one, oldest first
+		std::span<const uint64_t> GetHashHistory() const { return m_HashHistory; }
 	private:
 		Board m_Board;
 		std::deque<Move> m_MoveHistory;
-		std::unordered_map<size_t, int> m_BoardHistoryHashes;
 		std::vector<Board> m_BoardHistory;
+		std::vector<uint64_t> m_HashHistory;
 	};
 
 }
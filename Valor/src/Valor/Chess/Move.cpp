@@ -11,6 +11,8 @@ namespace Valor {
 	{
 		std::stringstream result;
 		result << Source.ToAlgebraic() << Target.ToAlgebraic();
+		if (Promotion != PieceType::None)
+			result << (char)(Piece::PieceTypeToChar(Promotion) | 0x20);
 		return result.str();
 	}
 
@@ -56,7 +58,20 @@ namespace Valor {
 	{
 		Tile source = Tile::FromAlgebraic(algebraic.substr(0, 2));
 		Tile target = Tile::FromAlgebraic(algebraic.substr(2, 2));
-		return Move(source, target);
+
+		// Promotions end with the piece, as in e7e8q
+		PieceType promotion = PieceType::None;
+		if (algebraic.size() > 4)
+		{
+			switch (algebraic[4] | 0x20)
+			{
+				case 'q': promotion = PieceType::Queen; break;
+				case 'r': promotion = PieceType::Rook; break;
+				case 'b': promotion = PieceType::Bishop; break;
+				case 'n': promotion = PieceType::Knight; break;
+			}
+		}
+		return Move(source, target, PieceType::None, 0, promotion);
 	}
 
 }
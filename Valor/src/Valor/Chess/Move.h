@@ -25,10 +25,10 @@ namespace Valor {
 		PieceType Piece = PieceType::None;
 		uint8_t Flags = 0;
 		PieceType Promotion = PieceType::None;
-		uint8_t Priority = 0;
+		int32_t Priority = 0; // Move ordering score, filled in by the searcher
 
 		Move() = default;
-		Move(Tile source, Tile target, PieceType piece = PieceType::None, uint8_t flags = 0, PieceType promotion = PieceType::None, uint8_t priority = 0)
+		Move(Tile source, Tile target, PieceType piece = PieceType::None, uint8_t flags = 0, PieceType promotion = PieceType::None, int32_t priority = 0)
 			: Source(source), Target(target), Piece(piece), Flags(flags), Promotion(promotion), Priority(priority)
 		{
 		}
@@ -46,6 +46,8 @@ namespace Valor {
 		bool IsCheck()     const { return Flags & MoveFlags::Check;     }
 		bool IsCheckmate() const { return Flags & MoveFlags::Checkmate; }
 
+		bool IsQuiet() const { return !(Flags & (MoveFlags::Capture | MoveFlags::Promotion)); }
+
 		bool IsValid() const { return Source.IsValid() && Target.IsValid(); }
 
 		std::string ToAlgebraic() const;
@@ -7,26 +7,29 @@ namespace Valor::MoveGeneratorSimple {
 
 	using AttackFunction = uint64_t(*)(int, uint64_t);
 
-	static void addMoves(uint64_t bitboard, AttackFunction getAttacks, std::vector<Move>& moves,
+	static void addMoves(uint64_t bitboard, AttackFunction getAttacks, PieceType pieceType, std::vector<Move>& moves,
 		uint64_t ownPieces, const Board& board)
 	{
+		uint64_t occupied = board.Occupied();
+
 		while (bitboard) {
 			int square = std::countr_zero(bitboard);
 			bitboard &= bitboard - 1;
 
-			uint64_t attacks = getAttacks(square, board.Occupied()) & ~ownPieces;
+			uint64_t attacks = getAttacks(square, occupied) & ~ownPieces;
 
 			while (attacks)
 			{
 				int target = std::countr_zero(attacks);
 				attacks &= attacks - 1;
 
-				moves.emplace_back(Move(square, target));
+				uint8_t flags = (occupied & (1ULL << target)) ? MoveFlags::Capture : 0;
+				moves.emplace_back(Move(square, target, pieceType, flags));
 			}
 		}
 	}
 
-	std::vector<Move> MoveGeneratorSimple::GeneratePseudoLegalMoves(const Board& board)
+	std::vector<Move> GeneratePseudoLegalMoves(const Board& board)
 	{
 		std::vector<Move> moves;
 		moves.reserve(50);
@@ -35,11 +38,11 @@ namespace Valor::MoveGeneratorSimple {
 		uint64_t ownPieces = board.AllPieces(isWhite);
 
 		// Using function pointers to avoid lambda-related issues
-		addMoves(board.Knights() & ownPieces, MagicBitboard::GetKnightAttacks, moves, ownPieces, board);
-		addMoves(board.Bishops() & ownPieces, MagicBitboard::GetBishopAttacks, moves, ownPieces, board);
-		addMoves(board.Rooks() & ownPieces, MagicBitboard::GetRookAttacks, moves, ownPieces, board);
-		addMoves(board.Queens() & ownPieces, MagicBitboard::GetQueenAttacks, moves, ownPieces, board);
-		addMoves(board.Kings() & ownPieces, MagicBitboard::GetKingAttacks, moves, ownPieces, board);
+		addMoves(board.Knights() & ownPieces, MagicBitboard::GetKnightAttacks, PieceType::Knight, moves, ownPieces, board);
+		addMoves(board.Bishops() & ownPieces, MagicBitboard::GetBishopAttacks, PieceType::Bishop, moves, ownPieces, board);
+		addMoves(board.Rooks() & ownPieces, MagicBitboard::GetRookAttacks, PieceType::Rook, moves, ownPieces, board);
+		addMoves(board.Queens() & ownPieces, MagicBitboard::GetQueenAttacks, PieceType::Queen, moves, ownPieces, board);
+		addMoves(board.Kings() & ownPieces, MagicBitboard::GetKingAttacks, PieceType::King, moves, ownPieces, board);
 
 		// Handle pawns and castling separately
 		GeneratePawnMoves(board, moves);
@@ -86,16 +89,24 @@ namespace Valor::MoveGeneratorSimple {
 			while (attacks) {
 				int target = std::countr_zero(attacks);
 				attacks &= attacks - 1;
-				if (IsPromotionRank(target, isWhite))
+
+				uint8_t flags = 0;
+				if (occupied & (1ULL << target))
+					flags |= MoveFlags::Capture;
+				else if ((target % 8) != (square % 8))
+					flags |= MoveFlags::Capture | MoveFlags::EnPassant;
+
+				if (IsPromotionRank(target / 8, isWhite))
 				{
-					moves.emplace_back(Move(square, target, PieceType::Pawn, 0, PieceType::Queen));
-					moves.emplace_back(Move(square, target, PieceType::Pawn, 0, PieceType::Rook));
-					moves.emplace_back(Move(square, target, PieceType::Pawn, 0, PieceType::Bishop));
-					moves.emplace_back(Move(square, target, PieceType::Pawn, 0, PieceType::Knight));
+					flags |= MoveFlags::Promotion;
+					moves.emplace_back(Move(square, target, PieceType::Pawn, flags, PieceType::Queen));
+					moves.emplace_back(Move(square, target, PieceType::Pawn, flags, PieceType::Rook));
+					moves.emplace_back(Move(square, target, PieceType::Pawn, flags, PieceType::Bishop));
+					moves.emplace_back(Move(square, target, PieceType::Pawn, flags, PieceType::Knight));
 				}
 				else
 				{
-					moves.emplace_back(Move(square, target, PieceType::Pawn));
+					moves.emplace_back(Move(square, target, PieceType::Pawn, flags));
 				}
 			}
 		}
@@ -117,7 +128,7 @@ namespace Valor::MoveGeneratorSimple {
 			attacks = MagicBitboard::GetWhitePawnAttacks(square) & occupied;
 
 			enPassantCapture = 0;
-			if (enPassantFile != -1 && (file == enPassantFile - 1 || file == enPassantFile + 1)) {
+			if (rank == 4 && (file == enPassantFile - 1 || file == enPassantFile + 1)) {
 				enPassantCapture = (1ULL << (square + 7)) | (1ULL << (square + 9));
 				enPassantCapture &= (1ULL << ((rank + 1) * 8 + enPassantFile));
 			}
@@ -130,7 +141,7 @@ namespace Valor::MoveGeneratorSimple {
 			attacks = MagicBitboard::GetBlackPawnAttacks(square) & occupied;
 
 			enPassantCapture = 0;
-			if (enPassantFile != -1 && (file == enPassantFile - 1 || file == enPassantFile + 1)) {
+			if (rank == 3 && (file == enPassantFile - 1 || file == enPassantFile + 1)) {
 				enPassantCapture = (1ULL << (square - 7)) | (1ULL << (square - 9));
 				enPassantCapture &= (1ULL << ((rank - 1) * 8 + enPassantFile));
 			}
@@ -145,7 +156,7 @@ namespace Valor::MoveGeneratorSimple {
 		bool isWhite = board.IsWhiteTurn();
 		int kingSquare = board.GetKingSquare(isWhite);
 
-		if (board.IsCheck(isWhite))
+		if (board.IsCheck())
 			return;
 
 		bool canCastleKingside = board.CanCastle(isWhite, true);
@@ -183,7 +194,7 @@ namespace Valor::MoveGeneratorSimple {
 			if (squaresAreEmpty({ sq1, sq2 }) &&
 				squaresAreSafe({ kingSquare, sq1, sq2 }))
 			{
-				moves.emplace_back(Move(kingSquare, sq2, PieceType::King));
+				moves.emplace_back(Move(kingSquare, sq2, PieceType::King, MoveFlags::Castling));
 			}
 		}
 
@@ -199,7 +210,7 @@ namespace Valor::MoveGeneratorSimple {
 			if (squaresAreEmpty({ sq1, sq2, sq3 }) &&
 				squaresAreSafe({ kingSquare, sq1, sq2 }))
 			{
-				moves.emplace_back(Move(kingSquare, sq2, PieceType::King));
+				moves.emplace_back(Move(kingSquare, sq2, PieceType::King, MoveFlags::Castling));
 			}
 		}
 	}
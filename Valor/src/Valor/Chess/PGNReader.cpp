@@ -0,0 +1,259 @@
+#include "vlpch.h"
+#include "Valor/Chess/PGNReader.h"
+
+#include <cstring>
+
+namespace Valor {
+
+	static bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	static std::string_view Trim(std::string_view text)
+	{
+		size_t begin = 0;
+		while (begin < text.size() && IsSpace(text[begin]))
+			begin++;
+		size_t end = text.size();
+		while (end > begin && IsSpace(text[end - 1]))
+			end--;
+		return text.substr(begin, end - begin);
+	}
+
+	// Start of the line after the one holding `offset`
+	static size_t NextLine(std::string_view text, size_t offset)
+	{
+		const char* newline = static_cast<const char*>(std::memchr(text.data() + offset, '\n', text.size() - offset));
+		return newline ? (size_t)(newline - text.data()) + 1 : text.size();
+	}
+
+	static bool IsBlankLine(std::string_view text, size_t offset)
+	{
+		while (offset < text.size() && text[offset] != '\n' && IsSpace(text[offset]))
+			offset++;
+		return offset == text.size() || text[offset] == '\n';
+	}
+
+	// A tag pair line starts with a bracket and the tag's name, unlike the [%clk 0:03:00] of a comment wrapped
+	// onto a new line
+	static bool IsHeaderLine(std::string_view text, size_t offset)
+	{
+		while (offset < text.size() && (text[offset] == ' ' || text[offset] == '\t'))
+			offset++;
+		return offset + 1 < text.size() && text[offset] == '[' && ((text[offset + 1] | 0x20) >= 'a' && (text[offset + 1] | 0x20) <= 'z');
+	}
+
+	// Offset just past the comment or variation starting at `offset`, or the end of the text if it isn't closed
+	static size_t SkipComment(std::string_view text, size_t offset)
+	{
+		const char* close = static_cast<const char*>(std::memchr(text.data() + offset, '}', text.size() - offset));
+		return close ? (size_t)(close - text.data()) + 1 : text.size();
+	}
+
+	static size_t SkipVariation(std::string_view text, size_t offset)
+	{
+		int depth = 0;
+		while (offset < text.size())
+		{
+			switch (text[offset])
+			{
+			case '{':
+				offset = SkipComment(text, offset);
+				continue;
+			case ';':
+				offset = NextLine(text, offset);
+				continue;
+			case '(':
+				depth++;
+				break;
+			case ')':
+				if (--depth == 0)
+					return offset + 1;
+				break;
+			}
+			offset++;
+		}
+		return offset;
+	}
+
+	// Start of the first game after the line holding `offset`: a tag pair line after a line that isn't one
+	static size_t FindGameStart(std::string_view text, size_t offset)
+	{
+		while (offset > 0 && text[offset - 1] != '\n')
+			offset--;
+
+		bool isAfterHeader = IsHeaderLine(text, offset);
+		for (offset = NextLine(text, offset); offset < text.size(); offset = NextLine(text, offset))
+		{
+			if (IsBlankLine(text, offset))
+				continue;
+
+			bool isHeader = IsHeaderLine(text, offset);
+			if (isHeader && !isAfterHeader)
+				return offset;
+			isAfterHeader = isHeader;
+		}
+		return text.size();
+	}
+
+	std::optional<std::string_view> PGNGame::FindHeader(std::string_view name) const
+	{
+		for (size_t offset = 0; offset < Headers.size(); offset = NextLine(Headers, offset))
+		{
+			std::string_view line = Headers.substr(offset, NextLine(Headers, offset) - offset);
+
+			size_t open = line.find('[');
+			if (open == std::string_view::npos || line.substr(open + 1, name.size()) != name)
+				continue;
+
+			size_t nameEnd = open + 1 + name.size();
+			if (nameEnd >= line.size() || !IsSpace(line[nameEnd]))
+				continue;
+
+			size_t valueBegin = line.find('"', nameEnd);
+			size_t valueEnd = line.rfind('"');
+			if (valueBegin == std::string_view::npos || valueEnd <= valueBegin)
+				return std::nullopt;
+			return line.substr(valueBegin + 1, valueEnd - valueBegin - 1);
+		}
+		return std::nullopt;
+	}
+
+	bool PGNGame::GetStartPosition(Board& board) const
+	{
+		if (std::optional<std::string_view> fen = FindHeader("FEN"))
+			return Board::FromFEN(*fen, board);
+
+		board.Reset();
+		return true;
+	}
+
+	bool PGNGame::NextMove(std::string_view& movetext, std::string_view& san)
+	{
+		while (true)
+		{
+			size_t begin = 0;
+			while (begin < movetext.size() && (IsSpace(movetext[begin]) || movetext[begin] == '.' || movetext[begin] == ')' || movetext[begin] == '}'))
+				begin++;
+			movetext.remove_prefix(begin);
+			if (movetext.empty())
+				return false;
+
+			switch (movetext[0])
+			{
+			case '{':
+				movetext.remove_prefix(SkipComment(movetext, 0));
+				continue;
+			case ';':
+			case '%':
+				movetext.remove_prefix(NextLine(movetext, 0));
+				continue;
+			case '(':
+				movetext.remove_prefix(SkipVariation(movetext, 0));
+				continue;
+			case '$':
+			{
+				// Annotation glyphs, like $14
+				size_t end = 1;
+				while (end < movetext.size() && movetext[end] >= '0' && movetext[end] <= '9')
+					end++;
+				movetext.remove_prefix(end);
+				continue;
+			}
+			case '*':
+				return false;
+			}
+
+			size_t end = 0;
+			while (end < movetext.size() && !IsSpace(movetext[end]) && !std::strchr("{}();$", movetext[end]))
+				end++;
+
+			// Move numbers, as in `12.` or `12...`
+			size_t digits = 0;
+			while (digits < end && movetext[digits] >= '0' && movetext[digits] <= '9')
+				digits++;
+			if (digits > 0 && digits < end && movetext[digits] == '.')
+			{
+				movetext.remove_prefix(digits);
+				continue;
+			}
+
+			std::string_view token = movetext.substr(0, end);
+			movetext.remove_prefix(end);
+			if (token == "1-0" || token == "0-1" || token == "1/2-1/2")
+				return false;
+
+			san = token;
+			return true;
+		}
+	}
+
+	bool PGNReader::Next(PGNGame& game)
+	{
+		size_t offset = 0;
+		while (offset < m_Text.size() && IsBlankLine(m_Text, offset))
+			offset = NextLine(m_Text, offset);
+		if (offset == m_Text.size())
+		{
+			m_Text = {};
+			return false;
+		}
+
+		size_t headersBegin = offset;
+		while (offset < m_Text.size() && IsHeaderLine(m_Text, offset))
+			offset = NextLine(m_Text, offset);
+		game.Headers = Trim(m_Text.substr(headersBegin, offset - headersBegin));
+
+		// The movetext runs up to the next tag pair line, but a comment may run over lines that look like one
+		size_t movetextBegin = offset;
+		bool isComment = false;
+		while (offset < m_Text.size() && (isComment || !IsHeaderLine(m_Text, offset)))
+		{
+			size_t lineEnd = NextLine(m_Text, offset);
+			for (; offset < lineEnd; offset++)
+			{
+				char c = m_Text[offset];
+				if (isComment)
+					isComment = c != '}';
+				else if (c == '{')
+					isComment = true;
+				else if (c == ';')
+					break;
+			}
+			offset = lineEnd;
+		}
+		game.Movetext = Trim(m_Text.substr(movetextBegin, offset - movetextBegin));
+
+		m_Text.remove_prefix(offset);
+		return true;
+	}
+
+	bool PGNFile::Open(const std::string& path)
+	{
+		if (!m_File.Open(path, MappedFile::Access::Sequential))
+		{
+			std::cerr << "Could not open PGN file " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<std::string_view> PGNFile::Split(size_t count) const
+	{
+		std::string_view text = GetText();
+		count = std::max<size_t>(count, 1);
+
+		// Each range ends before the first game starting after its share of the bytes
+		std::vector<std::string_view> ranges;
+		size_t begin = 0;
+		for (size_t i = 1; i <= count && begin < text.size(); i++)
+		{
+			size_t end = i < count ? FindGameStart(text, std::max(begin, text.size() * i / count)) : text.size();
+			ranges.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+		return ranges;
+	}
+
+}
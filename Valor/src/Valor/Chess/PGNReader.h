@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Valor {
+
+	// A game read from PGN text. The views point into the text.
+	struct PGNGame
+	{
+		std::string_view Headers; // The tag pairs, as written
+		std::string_view Movetext;
+
+		// Value of a tag pair like [White "Carlsen, Magnus"] without its quotes. Escaped characters are left as written.
+		std::optional<std::string_view> FindHeader(std::string_view name) const;
+
+		// Sets up the position the game starts from, the one in its FEN tag if it has one. Returns false if that
+		// FEN doesn't parse.
+		bool GetStartPosition(Board& board) const;
+
+		// Plays the main line from the start position, calling `callback(position, move)` before each move.
+		// Returns false at the first move that doesn't parse or isn't legal.
+		template<typename TCallback>
+		bool Replay(TCallback&& callback) const
+		{
+			Board board;
+			if (!GetStartPosition(board))
+				return false;
+
+			std::string_view movetext = Movetext;
+			std::string_view san;
+			while (NextMove(movetext, san))
+			{
+				Move move = board.ParseSAN(san);
+				if (!move.IsValid())
+					return false;
+
+				callback(static_cast<const Board&>(board), move);
+				board.MakeMove(move);
+			}
+			return true;
+		}
+
+		// Splits the next move of the main line off `movetext`, passing over move numbers, comments, variations
+		// and annotation glyphs. Returns false once there are none left or at the result.
+		static bool NextMove(std::string_view& movetext, std::string_view& san);
+	};
+
+	// Reads PGN text a game at a time, without copying it. A game is its tag pairs and the movetext after
+	// them, up to the next tag pair line outside a comment.
+	class PGNReader
+	{
+	public:
+		explicit PGNReader(std::string_view text) : m_Text(text) {}
+
+		// Reads the next game into `game`. Returns false at the end of the text.
+		bool Next(PGNGame& game);
+	private:
+		std::string_view m_Text;
+	};
+
+	// A PGN file mapped into memory, so files of any size are read without loading them first
+	class PGNFile
+	{
+	public:
+		// Returns false if the file can't be mapped
+		bool Open(const std::string& path);
+		void Close() { m_File.Close(); }
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+		std::string_view GetText() const { return { reinterpret_cast<const char*>(m_File.GetData()), m_File.GetSize() }; }
+
+		// Up to `count` ranges of whole games of about the same size, covering the file in order
+		std::vector<std::string_view> Split(size_t count) const;
+
+		// Reads the file on up to `threadCount` threads, each reading one range from `Split`, and calls
+		// `callback(game, threadIndex)` for every game. Calls from different threads run at the same time.
+		template<typename TCallback>
+		void ReadParallel(unsigned threadCount, TCallback&& callback) const
+		{
+			std::vector<std::string_view> ranges = Split(std::max(threadCount, 1u));
+
+			std::vector<std::thread> threads;
+			for (unsigned i = 0; i < ranges.size(); i++)
+			{
+				threads.emplace_back([&, i]()
+				{
+					PGNReader reader(ranges[i]);
+					PGNGame game;
+					while (reader.Next(game))
+						callback(static_cast<const PGNGame&>(game), i);
+				});
+			}
+
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+	private:
+		MappedFile m_File;
+	};
+
+}
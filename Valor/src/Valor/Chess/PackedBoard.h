@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Valor {
+
+	// A position in 32 bytes, for data sets too large to keep as FEN text. Made by `Board::ToPacked` and read
+	// back by `Board::FromPacked`. Positions with more than 32 pieces can't be packed.
+	struct PackedBoard
+	{
+		uint64_t Occupancy = 0;
+
+		// A 4 bit code for each piece, in the order of the occupied squares from a1, two to a byte with the first in
+		// the low bits. The code is the piece type, plus 8 for Black.
+		std::array<uint8_t, 16> Pieces{};
+
+		uint16_t FullmoveNumber = 1;
+		uint8_t HalfmoveCounter = 0;
+		uint8_t EnPassantFile = 0xff;
+
+		// Black to move in bit 0, then the castling rights in bits 1 to 4: White queen side, White king side,
+		// Black queen side, Black king side
+		uint8_t State = 0;
+
+		// Always zero, so equal positions pack to equal bytes
+		std::array<uint8_t, 3> Reserved{};
+
+		bool operator==(const PackedBoard& other) const = default;
+	};
+
+	static_assert(sizeof(PackedBoard) == 32);
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Valor/Chess/Piece.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Valor {
+
+	// A score split into its midgame and endgame parts, blended by the game phase
+	struct TaperedScore
+	{
+		int Midgame = 0;
+		int Endgame = 0;
+
+		TaperedScore& operator+=(const TaperedScore& other) { Midgame += other.Midgame; Endgame += other.Endgame; return *this; }
+		TaperedScore& operator-=(const TaperedScore& other) { Midgame -= other.Midgame; Endgame -= other.Endgame; return *this; }
+		TaperedScore operator*(int factor) const { return { Midgame * factor, Endgame * factor }; }
+
+		// `phase` runs from 0 (bare kings and pawns) to `MaxGamePhase` (all pieces on the board)
+		int Blend(int phase) const;
+	};
+
+	constexpr int MaxGamePhase = 24;
+
+	inline int TaperedScore::Blend(int phase) const
+	{
+		phase = std::clamp(phase, 0, MaxGamePhase);
+		return (Midgame * phase + Endgame * (MaxGamePhase - phase)) / MaxGamePhase;
+	}
+
+	// What one piece on one square adds to the board's running evaluation terms. Material and bonus are
+	// signed, positive for White; the phase weight is 1 for minors, 2 for rooks and 4 for queens.
+	struct PieceSquareEntry
+	{
+		int Material = 0;
+		TaperedScore Bonus;
+		int Phase = 0;
+	};
+
+	namespace PieceSquareTables {
+
+		// Indexed by [piece type][color][square]. The values are the evaluator's, defined with its parameters.
+		using EntryTable = std::array<std::array<std::array<PieceSquareEntry, 64>, 2>, 6>;
+		extern const EntryTable Entries;
+
+		// Inline, since the board looks entries up for every piece it places or removes
+		inline const PieceSquareEntry& Get(PieceType type, PieceColor color, int square)
+		{
+			return Entries[(int)type][(int)color][square];
+		}
+
+	}
+
+}
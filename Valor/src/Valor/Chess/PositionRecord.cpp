@@ -0,0 +1,87 @@
+#include "vlpch.h"
+#include "Valor/Chess/PositionRecord.h"
+
+namespace Valor {
+
+	uint16_t PositionRecord::PackMove(Move move)
+	{
+		if (!move.IsValid())
+			return 0;
+
+		int promotion = move.Promotion == PieceType::None ? 0 : (int)move.Promotion;
+		return (uint16_t)(move.Target | move.Source << 6 | promotion << 12);
+	}
+
+	Move PositionRecord::UnpackMove(uint16_t packed)
+	{
+		if (packed == 0)
+			return Move();
+
+		int promotion = (packed >> 12) & 0x7;
+		Move move(Tile(packed & 0x3f), Tile((packed >> 6) & 0x3f));
+		move.Promotion = promotion ? static_cast<PieceType>(promotion) : PieceType::None;
+		return move;
+	}
+
+	bool PositionRecordWriter::Open(const std::string& path)
+	{
+		Close();
+
+		m_File.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_File)
+		{
+			std::cerr << "Could not create record file " << path << std::endl;
+			return false;
+		}
+
+		m_Buffer.reserve(BufferSize);
+		m_RecordCount = 0;
+		m_IsFailed = false;
+		return true;
+	}
+
+	bool PositionRecordWriter::Close()
+	{
+		if (!m_File.is_open())
+			return !m_IsFailed;
+
+		Flush();
+		m_File.close();
+		m_IsFailed |= m_File.fail();
+		return !m_IsFailed;
+	}
+
+	void PositionRecordWriter::Write(const PositionRecord& record)
+	{
+		m_Buffer.push_back(record);
+		m_RecordCount++;
+		if (m_Buffer.size() == BufferSize)
+			Flush();
+	}
+
+	void PositionRecordWriter::Flush()
+	{
+		m_File.write(reinterpret_cast<const char*>(m_Buffer.data()), (std::streamsize)(m_Buffer.size() * sizeof(PositionRecord)));
+		m_IsFailed |= !m_File;
+		m_Buffer.clear();
+	}
+
+	bool PositionRecordFile::Open(const std::string& path, MappedFile::Access access)
+	{
+		if (!m_File.Open(path, access))
+		{
+			std::cerr << "Could not open record file " << path << std::endl;
+			return false;
+		}
+
+		if (m_File.GetSize() % sizeof(PositionRecord) != 0)
+		{
+			std::cerr << path << " is not a record file" << std::endl;
+			m_File.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+}
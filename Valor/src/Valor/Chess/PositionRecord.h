@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Valor/Chess/Move.h"
+#include "Valor/Chess/PackedBoard.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Valor {
+
+	// A packed position and what a data set knows about it. Record files are these back to back with no header,
+	// in the byte order of the machine, so files can be joined by concatenating them.
+	struct PositionRecord
+	{
+		constexpr static int16_t NoScore = INT16_MIN;
+		constexpr static uint8_t NoResult = 0xff;
+
+		PackedBoard Position;
+		int16_t Score = NoScore; // Centipawns from White's point of view
+		uint16_t BestMove = 0; // As `PackMove` packs it, zero for none
+		uint8_t Result = NoResult; // 0 for a Black win, 1 for a draw, 2 for a White win
+		std::array<uint8_t, 3> Reserved{};
+
+		// Target square in bits 0-5, source square in bits 6-11 and the promotion (knight to queen as 1 to 4) in
+		// bits 12-14, like a Polyglot book but with castling written as the king's move
+		static uint16_t PackMove(Move move);
+		static Move UnpackMove(uint16_t packed);
+	};
+
+	static_assert(sizeof(PositionRecord) == 40);
+
+	// Writes a record file from the start, a block of records at a time
+	class PositionRecordWriter
+	{
+	public:
+		~PositionRecordWriter() { Close(); }
+
+		// Returns false if the file can't be created
+		bool Open(const std::string& path);
+
+		// Returns false if any write failed
+		bool Close();
+
+		void Write(const PositionRecord& record);
+
+		size_t GetRecordCount() const { return m_RecordCount; }
+	private:
+		void Flush();
+	private:
+		constexpr static size_t BufferSize = 1 << 14; // Records
+	private:
+		std::ofstream m_File;
+		std::vector<PositionRecord> m_Buffer;
+		size_t m_RecordCount = 0;
+		bool m_IsFailed = false;
+	};
+
+	// A record file mapped into memory, so files of any size are read without loading them first
+	class PositionRecordFile
+	{
+	public:
+		// Returns false if the file can't be mapped or isn't a whole number of records
+		bool Open(const std::string& path, MappedFile::Access access = MappedFile::Access::Sequential);
+		void Close() { m_File.Close(); }
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+
+		std::span<const PositionRecord> GetRecords() const
+		{
+			return { reinterpret_cast<const PositionRecord*>(m_File.GetData()), m_File.GetSize() / sizeof(PositionRecord) };
+		}
+	private:
+		MappedFile m_File;
+	};
+
+}
@@ -0,0 +1,42 @@
+#include "vlpch.h"
+#include "Valor/Core/CPUFeatures.h"
+
+#if defined(VL_X86_64) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Valor {
+
+	static bool DetectAVX2()
+	{
+#if defined(__AVX2__)
+		return true;
+#elif defined(VL_X86_64) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// AVX itself, and an operating system that saves the upper halves of the vector registers
+		__cpuid(info, 1);
+		bool hasAVX = (info[2] & (1 << 28)) && (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+		if (!hasAVX)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return info[1] & (1 << 5);
+#elif defined(VL_X86_64)
+		// Checks the operating system support too
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	bool HasAVX2()
+	{
+		static const bool hasAVX2 = DetectAVX2();
+		return hasAVX2;
+	}
+
+}
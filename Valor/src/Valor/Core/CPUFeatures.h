@@ -0,0 +1,19 @@
+#pragma once
+
+// Marks a function to be compiled for AVX2 whatever the build targets, so the CPU can pick it at runtime
+// through `HasAVX2`. MSVC compiles AVX2 intrinsics anywhere and needs no attribute.
+#if defined(__x86_64__) || defined(_M_X64)
+	#define VL_X86_64
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#define VL_TARGET_AVX2
+	#else
+		#define VL_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace Valor {
+
+	// Whether both the CPU and the operating system support AVX2. Always false off x86-64.
+	bool HasAVX2();
+
+}
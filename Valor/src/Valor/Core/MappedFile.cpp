@@ -0,0 +1,124 @@
+#include "vlpch.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Valor {
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			m_Data = std::exchange(other.m_Data, nullptr);
+			m_Size = std::exchange(other.m_Size, 0);
+#ifdef _WIN32
+			m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& path, Access access)
+	{
+		Close();
+
+		DWORD flags = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// The mapping keeps its own reference to the file
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			return false;
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(size.QuadPart);
+		m_Mapping = mapping;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!m_Data)
+			return;
+
+		UnmapViewOfFile(m_Data);
+		CloseHandle(m_Mapping);
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Mapping = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& path, Access access)
+	{
+		Close();
+
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return false;
+
+		struct stat status;
+		if (fstat(fd, &status) == -1 || status.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		// The mapping stays valid after the descriptor is closed
+		void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+			return false;
+
+		if (access == Access::Sequential)
+			madvise(data, status.st_size, MADV_SEQUENTIAL);
+
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(status.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!m_Data)
+			return;
+
+		munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+#endif
+
+}
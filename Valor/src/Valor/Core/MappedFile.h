@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Valor {
+
+	// Read-only memory mapping of a whole file. Pages are only read from disk when first touched.
+	class MappedFile
+	{
+	public:
+		// How the file will be read, so the system can read ahead of it or not
+		enum class Access
+		{
+			Random,
+			Sequential
+		};
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Returns false if the file doesn't exist, is empty or can't be mapped
+		bool Open(const std::string& path, Access access = Access::Random);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+		std::span<const uint8_t> GetBytes() const { return { m_Data, m_Size }; }
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+#ifdef _WIN32
+		void* m_Mapping = nullptr;
+#endif
+	};
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+
+#include <cstdint>
+
+// Zobrist hashing with the fixed keys of the Polyglot opening book format. Unlike `ZobristHasher`, whose keys
+// are private to the engine, these have to match the keys the book was written with.
+namespace Valor::PolyglotHasher {
+
+	uint64_t Hash(const Board& board);
+
+}
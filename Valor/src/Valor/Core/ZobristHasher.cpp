@@ -15,12 +15,17 @@ namespace Valor::ZobristHasher {
 	static uint64_t s_CastlingKeys[NumCastlingRights];
 	static uint64_t s_EnPassantKeys[NumEnPassantFiles];
 	static uint64_t s_SideKey;
+	static uint64_t s_PawnBaseKey;
+
+	// Fixed seed, so keys (and anything stored under them) are the same in every process. The raw output
+	// of mt19937_64 is fixed by the standard, unlike the distributions built on top of it.
+	constexpr uint64_t KeySeed = 0x56616c6f72ull;
+
+	static std::mt19937_64 s_Generator(KeySeed);
 
 	static uint64_t Random64()
 	{
-		std::mt19937_64 generator(std::random_device{}());
-		std::uniform_int_distribution<uint64_t> distribution;
-		return distribution(generator);
+		return s_Generator();
 	}
 
 	static void Init()
@@ -37,6 +42,9 @@ namespace Valor::ZobristHasher {
 			s_EnPassantKeys[i] = Random64();
 
 		s_SideKey = Random64();
+
+		// Drawn last, so the keys above stay the same
+		s_PawnBaseKey = Random64();
 	}
 
 	uint64_t Hash(const Board& board)
@@ -45,21 +53,23 @@ namespace Valor::ZobristHasher {
 
 		for (size_t piece = 0; piece < NumPieceTypes; ++piece)
 		{
-			uint64_t pieceBitboard = board.GetPieceBitboard(static_cast<PieceType>(piece + 1));
-
-			while (pieceBitboard)
+			for (size_t color = 0; color < NumColors; ++color)
 			{
-				int square = std::countr_zero(pieceBitboard);
-				int color = board.GetPiece(square).Color == PieceColor::White ? 0 : 1;
-				hash ^= s_PieceKeys[piece][color][square];
-				pieceBitboard &= pieceBitboard - 1;
+				uint64_t pieceBitboard = board.GetPieceBitboard(color == 0, static_cast<PieceType>(piece));
+
+				while (pieceBitboard)
+				{
+					int square = std::countr_zero(pieceBitboard);
+					hash ^= s_PieceKeys[piece][color][square];
+					pieceBitboard &= pieceBitboard - 1;
+				}
 			}
 		}
 
-		if (board.CanCastle(true, true)) hash ^= s_CastlingKeys[0];
-		if (board.CanCastle(true, false)) hash ^= s_CastlingKeys[1];
-		if (board.CanCastle(false, true)) hash ^= s_CastlingKeys[2];
-		if (board.CanCastle(false, false)) hash ^= s_CastlingKeys[3];
+		if (board.CanCastle(true, false)) hash ^= s_CastlingKeys[0];
+		if (board.CanCastle(true, true)) hash ^= s_CastlingKeys[1];
+		if (board.CanCastle(false, false)) hash ^= s_CastlingKeys[2];
+		if (board.CanCastle(false, true)) hash ^= s_CastlingKeys[3];
 
 		if (board.GetEnPassantFile() != 0xff)
 			hash ^= s_EnPassantKeys[board.GetEnPassantFile()];
@@ -70,10 +80,29 @@ namespace Valor::ZobristHasher {
 		return hash;
 	}
 
+	uint64_t PawnHash(const Board& board)
+	{
+		// Starts from a nonzero key, so an empty pawn table slot never matches a position without pawns
+		uint64_t hash = s_PawnBaseKey;
+
+		for (size_t color = 0; color < NumColors; ++color)
+		{
+			uint64_t pawns = board.Pawns(color == 0);
+			while (pawns)
+			{
+				int square = std::countr_zero(pawns);
+				hash ^= s_PieceKeys[static_cast<int>(PieceType::Pawn)][color][square];
+				pawns &= pawns - 1;
+			}
+		}
+
+		return hash;
+	}
+
 	void UpdateHash(uint64_t& hash, const Board& board, Move move)
 	{
 		int color = board.GetPiece(move.Source).Color == PieceColor::White ? 0 : 1;
-		int piece = static_cast<int>(board.GetPiece(move.Source).Type) - 1;
+		int piece = static_cast<int>(board.GetPiece(move.Source).Type);
 
 		// Remove old piece-square hash
 		hash ^= s_PieceKeys[piece][color][move.Source];
@@ -111,6 +140,26 @@ namespace Valor::ZobristHasher {
 		hash ^= s_SideKey;
 	}
 
+	uint64_t GetPieceKey(PieceType type, PieceColor color, int square)
+	{
+		return s_PieceKeys[static_cast<int>(type)][static_cast<int>(color)][square];
+	}
+
+	uint64_t GetCastlingKey(int index)
+	{
+		return s_CastlingKeys[index];
+	}
+
+	uint64_t GetEnPassantKey(int file)
+	{
+		return s_EnPassantKeys[file];
+	}
+
+	uint64_t GetSideKey()
+	{
+		return s_SideKey;
+	}
+
 	static bool s_IsInitialized = []()
 	{
 		Init();
@@ -7,6 +7,15 @@
 namespace Valor::ZobristHasher {
 
 	uint64_t Hash(const Board& board);
+
+	// Key of the pawns alone, for caching pawn structure evaluation
+	uint64_t PawnHash(const Board& board);
 	void UpdateHash(uint64_t& hash, const Board& board, Move move);
 
+	// Individual keys, for boards that maintain their hash incrementally
+	uint64_t GetPieceKey(PieceType type, PieceColor color, int square);
+	uint64_t GetCastlingKey(int index); // Indexed like the board's castling rights
+	uint64_t GetEnPassantKey(int file);
+	uint64_t GetSideKey();
+
 }
@@ -0,0 +1,128 @@
+#include "vlpch.h"
+#include "Valor/Engine/Book/PolyglotBook.h"
+
+#include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
+#include "Valor/Core/PolyglotHasher.h"
+
+#include <algorithm>
+
+namespace Valor::Engine {
+
+	// Entry layout: key (8 bytes), move (2), weight (2), learn data (4), all big-endian
+	static uint64_t ReadBigEndian(const uint8_t* data, int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; i++)
+			value = (value << 8) | data[i];
+		return value;
+	}
+
+	// Book moves pack the target square in bits 0-5, the source square in bits 6-11 and the promotion
+	// (knight to queen as 1 to 4) in bits 12-14. Castling is written as the king capturing its own rook.
+	static Move DecodeMove(uint16_t bookMove, const Board& board)
+	{
+		Tile target = bookMove & 0x3f;
+		Tile source = (bookMove >> 6) & 0x3f;
+		int promotion = (bookMove >> 12) & 0x7;
+
+		if (board.GetPiece(source).Type == PieceType::King)
+		{
+			if (source == Tiles::E1 && target == Tiles::H1) target = Tiles::G1;
+			else if (source == Tiles::E1 && target == Tiles::A1) target = Tiles::C1;
+			else if (source == Tiles::E8 && target == Tiles::H8) target = Tiles::G8;
+			else if (source == Tiles::E8 && target == Tiles::A8) target = Tiles::C8;
+		}
+
+		Move move(source, target);
+		move.Promotion = promotion ? static_cast<PieceType>(promotion) : PieceType::None;
+		return move;
+	}
+
+	bool PolyglotBook::Open(const std::string& path)
+	{
+		if (!m_File.Open(path))
+		{
+			std::cerr << "Could not open opening book " << path << std::endl;
+			return false;
+		}
+
+		if (m_File.GetSize() % EntrySize != 0)
+		{
+			std::cerr << "Opening book " << path << " is not a Polyglot book" << std::endl;
+			m_File.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	std::vector<BookMove> PolyglotBook::GetMoves(const Board& board) const
+	{
+		std::vector<BookMove> bookMoves;
+		if (!IsOpen())
+			return bookMoves;
+
+		const uint8_t* data = m_File.GetData();
+		size_t entryCount = GetEntryCount();
+		uint64_t key = PolyglotHasher::Hash(board);
+
+		// First entry with a key not below the position's
+		size_t low = 0;
+		size_t high = entryCount;
+		while (low < high)
+		{
+			size_t middle = low + (high - low) / 2;
+			if (ReadBigEndian(data + middle * EntrySize, 8) < key)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		std::vector<Move> legalMoves;
+		for (size_t i = low; i < entryCount; i++)
+		{
+			const uint8_t* entry = data + i * EntrySize;
+			if (ReadBigEndian(entry, 8) != key)
+				break;
+
+			if (legalMoves.empty())
+				legalMoves = MoveGeneratorSimple::GenerateLegalMoves(board);
+
+			// Matching against the legal moves fills in the move's flags, and drops moves from key collisions
+			Move move = DecodeMove((uint16_t)ReadBigEndian(entry + 8, 2), board);
+			auto legal = std::find_if(legalMoves.begin(), legalMoves.end(),
+				[&move](const Move& other) { return other == move && other.Promotion == move.Promotion; });
+			if (legal != legalMoves.end())
+				bookMoves.push_back({ *legal, (uint16_t)ReadBigEndian(entry + 10, 2) });
+		}
+
+		std::stable_sort(bookMoves.begin(), bookMoves.end(),
+			[](const BookMove& a, const BookMove& b) { return a.Weight > b.Weight; });
+		return bookMoves;
+	}
+
+	std::optional<Move> PolyglotBook::Probe(const Board& board, BookSelection selection)
+	{
+		// Zero weights mark moves the book knows but doesn't recommend
+		std::vector<BookMove> bookMoves = GetMoves(board);
+		if (bookMoves.empty() || bookMoves.front().Weight == 0)
+			return std::nullopt;
+
+		if (selection == BookSelection::Best)
+			return bookMoves.front().Move;
+
+		uint32_t totalWeight = 0;
+		for (const BookMove& bookMove : bookMoves)
+			totalWeight += bookMove.Weight;
+
+		uint32_t pick = std::uniform_int_distribution<uint32_t>(0, totalWeight - 1)(m_Random);
+		for (const BookMove& bookMove : bookMoves)
+		{
+			if (pick < bookMove.Weight)
+				return bookMove.Move;
+			pick -= bookMove.Weight;
+		}
+		return bookMoves.front().Move;
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Chess/Move.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Valor::Engine {
+
+	enum class BookSelection
+	{
+		Best,    // Always the highest weighted move
+		Weighted // Random, in proportion to the weights
+	};
+
+	struct BookMove
+	{
+		Valor::Move Move;
+		uint16_t Weight = 0;
+	};
+
+	// Polyglot opening book (.bin): 16 byte big-endian entries sorted by position key. The file is memory
+	// mapped and a position's entries are found by binary search, so opening even a large book is instant.
+	class PolyglotBook
+	{
+	public:
+		// Returns false if the file can't be mapped or isn't a whole number of entries
+		bool Open(const std::string& path);
+		void Close() { m_File.Close(); }
+
+		bool IsOpen() const { return m_File.IsOpen(); }
+		size_t GetEntryCount() const { return m_File.GetSize() / EntrySize; }
+
+		// Legal book moves for the position, highest weight first
+		std::vector<BookMove> GetMoves(const Board& board) const;
+
+		// Empty when the position isn't in the book
+		std::optional<Move> Probe(const Board& board, BookSelection selection = BookSelection::Weighted);
+	public:
+		constexpr static size_t EntrySize = 16;
+	private:
+		MappedFile m_File;
+		std::mt19937 m_Random{ std::random_device{}() };
+	};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// Static evaluations by Zobrist key, so transpositions and re-searches don't evaluate a position again.
+	// Each entry is a single word holding the upper 48 bits of the key and the score, so a probe never sees
+	// a key from one write with the score of another.
+	class EvalCache
+	{
+	public:
+		explicit EvalCache(size_t entryCount = DefaultSize) { Resize(entryCount); }
+
+		// Rounded down to a power of two. Clears the cache.
+		void Resize(size_t entryCount)
+		{
+			m_Entries.assign(std::bit_floor(std::max<size_t>(entryCount, 1)), 0);
+		}
+
+		size_t GetSize() const { return m_Entries.size(); }
+
+		bool Probe(uint64_t hash, int& score) const
+		{
+			uint64_t entry = m_Entries[hash & (m_Entries.size() - 1)];
+			if ((entry ^ hash) & KeyMask)
+				return false;
+
+			score = (int16_t)(entry & ~KeyMask);
+			return true;
+		}
+
+		// Scores outside the 16 bit range aren't cached
+		void Store(uint64_t hash, int score)
+		{
+			if (score != (int16_t)score)
+				return;
+			m_Entries[hash & (m_Entries.size() - 1)] = (hash & KeyMask) | (uint16_t)score;
+		}
+
+		void Clear() { std::fill(m_Entries.begin(), m_Entries.end(), 0); }
+	public:
+		constexpr static size_t DefaultSize = 1 << 18; // 2 MB
+	private:
+		constexpr static uint64_t KeyMask = ~0xffffull;
+
+		std::vector<uint64_t> m_Entries;
+	};
+
+}
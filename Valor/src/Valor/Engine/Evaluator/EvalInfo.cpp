@@ -0,0 +1,28 @@
+#include "vlpch.h"
+#include "Valor/Engine/Evaluator/EvalInfo.h"
+
+#include "Valor/Chess/MoveGeneration/MagicBitboard.h"
+
+namespace Valor::Engine {
+
+	EvalInfo::EvalInfo(const Board& board)
+	{
+		for (int color = 0; color < 2; color++)
+		{
+			bool isWhite = color == 0;
+			AddAttacks(color, PieceType::Pawn, GetPawnAttacks(board.Pawns(isWhite), isWhite));
+
+			int kingSquare = board.GetKingSquare(isWhite);
+			if (kingSquare == 64)
+				continue;
+
+			uint64_t kingAttacks = MagicBitboard::GetKingAttacks(kingSquare);
+			KingZone[color] = kingAttacks | (1ULL << kingSquare);
+			AddAttacks(color, PieceType::King, kingAttacks);
+		}
+
+		for (int color = 0; color < 2; color++)
+			MobilityArea[color] = ~board.AllPieces(color == 0) & ~Attacks[color ^ 1][(int)PieceType::Pawn];
+	}
+
+}
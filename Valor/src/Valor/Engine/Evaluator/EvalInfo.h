@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+
+#include <array>
+#include <cstdint>
+
+namespace Valor::Engine {
+
+	// Attack maps built once per evaluation and shared by every term that needs them, indexed by
+	// color (White = 0). The constructor fills in pawns and kings; the piece pass adds the rest
+	// through `AddAttacks` as it computes mobility.
+	struct EvalInfo
+	{
+		// Squares attacked by each piece type, by any piece, and by at least two pieces
+		std::array<std::array<uint64_t, 6>, 2> Attacks = {};
+		std::array<uint64_t, 2> AllAttacks = {};
+		std::array<uint64_t, 2> AttackedTwice = {};
+
+		// Squares counted for mobility: not holding an own piece and not attacked by an enemy pawn
+		std::array<uint64_t, 2> MobilityArea = {};
+
+		// The king's square and neighbours, empty if the king is missing
+		std::array<uint64_t, 2> KingZone = {};
+
+		// Enemy pieces attacking a side's king zone, and the sum of their attack weights
+		std::array<int, 2> KingAttackerCount = {};
+		std::array<int, 2> KingAttackWeight = {};
+
+		// Empty, for callers that fill in the pawn and king attacks themselves
+		EvalInfo() = default;
+		explicit EvalInfo(const Board& board);
+
+		void AddAttacks(int color, PieceType type, uint64_t attacks)
+		{
+			AttackedTwice[color] |= AllAttacks[color] & attacks;
+			AllAttacks[color] |= attacks;
+			Attacks[color][(int)type] |= attacks;
+		}
+
+		static uint64_t GetPawnAttacks(uint64_t pawns, bool isWhite)
+		{
+			if (isWhite)
+				return ((pawns & ~Board::FileA) << 7) | ((pawns & ~Board::FileH) << 9);
+			return ((pawns & ~Board::FileA) >> 9) | ((pawns & ~Board::FileH) >> 7);
+		}
+	};
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Valor/Chess/PieceSquareTables.h"
+
+// The evaluation terms ValorTune tunes. It writes its results back out in this file's format.
+
+namespace Valor::Engine::EvalParameters {
+
+	// Piece values by piece type, midgame and endgame. Only the evaluation uses these; move ordering and
+	// pruning keep the fixed values in Evaluator.h.
+	constexpr TaperedScore PieceValues[6] = {
+		{ 100, 100 }, // Pawn
+		{ 300, 300 }, // Knight
+		{ 320, 320 }, // Bishop
+		{ 500, 500 }, // Rook
+		{ 900, 900 }, // Queen
+		{ 0, 0 }, // King
+	};
+
+	// Piece-square bonuses by piece type, from White's point of view with rank 8 on top
+	constexpr int MidgameTables[6][64] = {
+		// Pawn
+		{
+			  0,   5,  10,  20,  20,  10,   5,   0,
+			  0,  10,  15,  25,  25,  15,  10,   0,
+			  0,   5,  10,  20,  20,  10,   5,   0,
+			  0,   0,   0,  15,  15,   0,   0,   0,
+			  5,   5,   0, -10, -10,   0,   5,   5,
+			  5,  10,  10, -20, -20,  10,  10,   5,
+			 10,  10,  20, -30, -30,  20,  10,  10,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Knight
+		{
+			-50, -40, -30, -30, -30, -30, -40, -50,
+			-40, -20,   0,   0,   0,   0, -20, -40,
+			-30,   0,  10,  15,  15,  10,   0, -30,
+			-30,   5,  15,  20,  20,  15,   5, -30,
+			-30,   0,  15,  20,  20,  15,   0, -30,
+			-30,   5,  10,  15,  15,  10,   5, -30,
+			-40, -20,   0,   5,   5,   0, -20, -40,
+			-50, -40, -30, -30, -30, -30, -40, -50,
+		},
+		// Bishop
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Rook
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Queen
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// King
+		{
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-20, -30, -30, -40, -40, -30, -30, -20,
+			-10, -20, -20, -20, -20, -20, -20, -10,
+			 20,  20,   0,   0,   0,   0,  20,  20,
+			 20,  30,  10,   0,   0,  10,  30,  20,
+		},
+	};
+
+	constexpr int EndgameTables[6][64] = {
+		// Pawn
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 80,  80,  80,  80,  80,  80,  80,  80,
+			 50,  50,  50,  50,  50,  50,  50,  50,
+			 30,  30,  30,  30,  30,  30,  30,  30,
+			 15,  15,  15,  15,  15,  15,  15,  15,
+			  5,   5,   5,   5,   5,   5,   5,   5,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Knight
+		{
+			-50, -40, -30, -30, -30, -30, -40, -50,
+			-40, -20,   0,   0,   0,   0, -20, -40,
+			-30,   0,  10,  15,  15,  10,   0, -30,
+			-30,   5,  15,  20,  20,  15,   5, -30,
+			-30,   0,  15,  20,  20,  15,   0, -30,
+			-30,   5,  10,  15,  15,  10,   5, -30,
+			-40, -20,   0,   5,   5,   0, -20, -40,
+			-50, -40, -30, -30, -30, -30, -40, -50,
+		},
+		// Bishop
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Rook
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// Queen
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		},
+		// King
+		{
+			-50, -40, -30, -20, -20, -30, -40, -50,
+			-30, -20, -10,   0,   0, -10, -20, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -30,   0,   0,   0,   0, -30, -30,
+			-50, -30, -30, -30, -30, -30, -30, -50,
+		},
+	};
+
+}
@@ -2,6 +2,9 @@
 
 #include "Valor/Chess/Board.h"
 
+#include <concepts>
+#include <span>
+
 namespace Valor::Engine {
 
 	constexpr int PawnValue = 100;
@@ -17,20 +20,68 @@ namespace Valor::Engine {
 	public:
 		virtual ~Evaluator() = default;
 		virtual int Evaluate(const Board& board) = 0;
+
+		// Like `Evaluate`, but may stop early once the score is sure to be outside (alpha, beta), both from
+		// White's point of view. It then clears `isExact` and only returns a bound: at most alpha, or at least beta.
+		virtual int EvaluateLazy(const Board& board, int alpha, int beta, bool& isExact)
+		{
+			isExact = true;
+			return Evaluate(board);
+		}
+
+		// `Evaluate` for every board into `scores`, which must be at least as long. Evaluators that can share
+		// work across positions override it; the scores are the same either way.
+		virtual void EvaluateBatch(std::span<const Board> boards, std::span<int> scores)
+		{
+			for (size_t i = 0; i < boards.size(); i++)
+				scores[i] = Evaluate(boards[i]);
+		}
+
+		// Follow the search path so evaluators with incremental state don't have to start from scratch at every
+		// node: `OnMakeMove` when the search enters `child`, made from `parent`, and `OnUnmakeMove` when it
+		// returns. `Evaluate` still has to work for boards reached any other way.
+		virtual void OnMakeMove(const Board& parent, const Board& child) {}
+		virtual void OnUnmakeMove() {}
+	};
+
+	// What the search needs from an evaluator. The search is instantiated per evaluator type, so a `final`
+	// evaluator is called directly rather than through the vtable; `Evaluator` itself still works for any other.
+	template<typename T>
+	concept SearchEvaluator = requires(T& evaluator, const Board& board, bool& isExact)
+	{
+		{ evaluator.Evaluate(board) } -> std::convertible_to<int>;
+		{ evaluator.EvaluateLazy(board, 0, 0, isExact) } -> std::convertible_to<int>;
+		evaluator.OnMakeMove(board, board);
+		evaluator.OnUnmakeMove();
 	};
 
-	class PieceValueEvaluator : public Evaluator
+	class PieceValueEvaluator final : public Evaluator
 	{
 	public:
 		virtual ~PieceValueEvaluator() = default;
 		virtual int Evaluate(const Board& board) override;
 	};
 
-	class PositionalEvaluator : public Evaluator
+	class PawnHashTable;
+	struct PawnEntry;
+
+	class PositionalEvaluator final : public Evaluator
 	{
 	public:
+		// Pawn structure is cached in `pawnTable` if given, which must outlive the evaluator
+		explicit PositionalEvaluator(PawnHashTable* pawnTable = nullptr) : m_PawnTable(pawnTable) {}
 		virtual ~PositionalEvaluator() = default;
 		virtual int Evaluate(const Board& board) override;
+
+		// Material and piece-square bonuses first; the other terms only when those leave the score near the window
+		virtual int EvaluateLazy(const Board& board, int alpha, int beta, bool& isExact) override;
+
+		// Computes the terms that only combine a few bitboards for several positions at once
+		virtual void EvaluateBatch(std::span<const Board> boards, std::span<int> scores) override;
+	private:
+		const PawnEntry& ProbePawns(const Board& board, PawnEntry& uncached) const;
+	private:
+		PawnHashTable* m_PawnTable;
 	};
 
 }
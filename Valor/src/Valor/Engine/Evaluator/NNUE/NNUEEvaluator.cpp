@@ -0,0 +1,141 @@
+#include "vlpch.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUEEvaluator.h"
+
+#include "Valor/Engine/PrincipalVariation.h"
+
+#include <algorithm>
+#include <bit>
+#include <span>
+
+namespace Valor::Engine {
+
+	// More changed pieces than this and a refresh is about as cheap as the update
+	constexpr int MaxChangedFeatures = 32;
+
+	// Features of `pieces` from `perspective`. Returns false once they don't fit in `features`.
+	static bool AddFeatures(std::array<int, MaxChangedFeatures>& features, int& count, uint64_t pieces,
+		int perspective, int kingSquare, int piece)
+	{
+		while (pieces)
+		{
+			if (count == MaxChangedFeatures)
+				return false;
+
+			int square = std::countr_zero(pieces);
+			pieces &= pieces - 1;
+			features[count++] = NNUENetwork::GetFeatureIndex((PieceColor)perspective, kingSquare,
+				(PieceType)(piece % 6), (PieceColor)(piece / 6), square);
+		}
+		return true;
+	}
+
+	NNUEEvaluator::NNUEEvaluator(const NNUENetwork& network)
+		: m_Network(network)
+	{
+		m_Path.resize(MaxPly + 1);
+	}
+
+	int NNUEEvaluator::Evaluate(const Board& board)
+	{
+		FollowPath(board);
+
+		// Entries up the path that were never evaluated stay uncomputed, the nearest computed one is the source
+		PathEntry& entry = m_Path[m_PathLength - 1];
+		for (int perspective = 0; perspective < 2; perspective++)
+		{
+			if (entry.IsComputed[perspective])
+				continue;
+
+			const PathEntry* source = nullptr;
+			for (size_t i = m_PathLength - 1; i-- > 0;)
+			{
+				if (m_Path[i].IsComputed[perspective])
+				{
+					source = &m_Path[i];
+					break;
+				}
+			}
+			ComputeAccumulator(entry, perspective, source);
+		}
+
+		int score = m_Network.Evaluate(entry.Accumulator, board.IsWhiteTurn());
+		return board.IsWhiteTurn() ? score : -score;
+	}
+
+	void NNUEEvaluator::OnMakeMove(const Board& parent, const Board& child)
+	{
+		FollowPath(parent);
+		PushPosition(child);
+	}
+
+	void NNUEEvaluator::OnUnmakeMove()
+	{
+		if (m_PathLength > 0)
+			m_PathLength--;
+	}
+
+	void NNUEEvaluator::FollowPath(const Board& board)
+	{
+		if (m_PathLength > 0 && m_Path[m_PathLength - 1].Hash == board.GetHash())
+			return;
+
+		m_PathLength = 0;
+		PushPosition(board);
+	}
+
+	void NNUEEvaluator::PushPosition(const Board& board)
+	{
+		if (m_PathLength == m_Path.size())
+			m_Path.resize(m_Path.size() * 2);
+
+		PathEntry& entry = m_Path[m_PathLength++];
+		entry.IsComputed = { false, false };
+		entry.Hash = board.GetHash();
+		for (int piece = 0; piece < 12; piece++)
+			entry.Pieces[piece] = board.GetPieceBitboard(piece < 6, (PieceType)(piece % 6));
+
+		// A board without a king can only come from a hand-made position, but mustn't index out of bounds
+		for (int perspective = 0; perspective < 2; perspective++)
+			entry.KingSquares[perspective] = std::min(board.GetKingSquare(perspective == 0), 63);
+	}
+
+	void NNUEEvaluator::ComputeAccumulator(PathEntry& entry, int perspective, const PathEntry* source)
+	{
+		int kingSquare = entry.KingSquares[perspective];
+
+		std::array<int, MaxChangedFeatures> added, removed;
+		int addedCount = 0, removedCount = 0;
+
+		bool isIncremental = source && source->KingSquares[perspective] == kingSquare;
+		for (int piece = 0; piece < 12 && isIncremental; piece++)
+		{
+			if (piece % 6 == (int)PieceType::King)
+				continue;
+
+			uint64_t before = source->Pieces[piece];
+			uint64_t after = entry.Pieces[piece];
+			isIncremental = AddFeatures(added, addedCount, after & ~before, perspective, kingSquare, piece)
+				&& AddFeatures(removed, removedCount, before & ~after, perspective, kingSquare, piece);
+		}
+
+		if (isIncremental)
+		{
+			m_Network.UpdateAccumulator(entry.Accumulator, source->Accumulator, perspective,
+				std::span(added.data(), addedCount), std::span(removed.data(), removedCount));
+		}
+		else
+		{
+			// 30 non-king pieces at most, so every feature fits
+			int count = 0;
+			for (int piece = 0; piece < 12; piece++)
+			{
+				if (piece % 6 != (int)PieceType::King)
+					AddFeatures(added, count, entry.Pieces[piece], perspective, kingSquare, piece);
+			}
+			m_Network.RefreshAccumulator(entry.Accumulator, perspective, std::span(added.data(), count));
+		}
+
+		entry.IsComputed[perspective] = true;
+	}
+
+}
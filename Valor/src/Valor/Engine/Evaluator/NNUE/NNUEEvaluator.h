@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Valor/Engine/Evaluator/Evaluator.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUENetwork.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// Evaluates with an `NNUENetwork`, keeping an accumulator for every position on the searched path. Each one
+	// is only computed once its position is evaluated: from the nearest computed accumulator up the path by the
+	// pieces that changed since, or from scratch when that perspective's king has moved.
+	class NNUEEvaluator final : public Evaluator
+	{
+	public:
+		// `network` must outlive the evaluator, and be loaded before anything is evaluated
+		explicit NNUEEvaluator(const NNUENetwork& network);
+		virtual ~NNUEEvaluator() = default;
+
+		virtual int Evaluate(const Board& board) override;
+
+		virtual void OnMakeMove(const Board& parent, const Board& child) override;
+		virtual void OnUnmakeMove() override;
+
+		// Drops every accumulator, for when the network's weights change
+		void Reset() { m_PathLength = 0; }
+	private:
+		struct PathEntry
+		{
+			NNUEAccumulator Accumulator;
+			std::array<bool, 2> IsComputed;
+			uint64_t Hash;
+			std::array<uint64_t, 12> Pieces; // Indexed by color * 6 + piece type
+			std::array<int, 2> KingSquares;
+		};
+
+		// Starts a new path at `board` if it isn't the current position
+		void FollowPath(const Board& board);
+		void PushPosition(const Board& board);
+
+		void ComputeAccumulator(PathEntry& entry, int perspective, const PathEntry* source);
+	private:
+		const NNUENetwork& m_Network;
+
+		// Entries past `m_PathLength` are kept for reuse, so entering a position doesn't clear an accumulator
+		std::vector<PathEntry> m_Path;
+		size_t m_PathLength = 0;
+	};
+
+}
@@ -0,0 +1,319 @@
+#include "vlpch.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUENetwork.h"
+
+#include "Valor/Core/CPUFeatures.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(VL_X86_64)
+	#include <immintrin.h>
+#endif
+
+namespace Valor::Engine {
+
+	// .nnue layout, little-endian: version, architecture hash, description, then the feature transformer and
+	// the layers after it, each behind a hash of its own. Only the sizes are checked, not the hashes.
+	constexpr uint32_t NNUEFileVersion = 0x7af32f16;
+
+	constexpr int AccumulatorSize = NNUEAccumulator::Size;
+	constexpr int HiddenSize = NNUENetwork::HiddenSize;
+
+	// Layer outputs are fixed point with 6 fractional bits, clipped to [0, 127] between layers. The final
+	// output is in units of 1/16, with a pawn worth 208 of those units.
+	constexpr int WeightScaleBits = 6;
+	constexpr int OutputScale = 16;
+	constexpr int NetworkPawnValue = 208;
+
+#if defined(VL_X86_64)
+	// Every x86-64 CPU has SSE2; the AVX2 kernels below are picked at runtime on the ones that also have AVX2
+	static const bool UseAVX2 = HasAVX2();
+
+	VL_TARGET_AVX2 static void ApplyFeaturesAVX2(int16_t* values, const int16_t* source, const int16_t* weights,
+		std::span<const int> added, std::span<const int> removed)
+	{
+		// The whole accumulator fits in registers, so it's only loaded and stored once
+		constexpr int VectorCount = AccumulatorSize / 16;
+		__m256i sums[VectorCount];
+		for (int i = 0; i < VectorCount; i++)
+			sums[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 16));
+
+		for (int feature : added)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < VectorCount; i++)
+				sums[i] = _mm256_add_epi16(sums[i], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i * 16)));
+		}
+		for (int feature : removed)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < VectorCount; i++)
+				sums[i] = _mm256_sub_epi16(sums[i], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i * 16)));
+		}
+
+		for (int i = 0; i < VectorCount; i++)
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i * 16), sums[i]);
+	}
+
+	VL_TARGET_AVX2 static void ClipAccumulatorAVX2(const int16_t* values, uint8_t* output)
+	{
+		const __m256i max = _mm256_set1_epi8(127);
+		for (int i = 0; i < AccumulatorSize; i += 32)
+		{
+			// Packing works per 128 bit lane, so the quarters are put back in order afterwards
+			__m256i packed = _mm256_packus_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 16)));
+			packed = _mm256_permute4x64_epi64(packed, 0xd8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_min_epu8(packed, max));
+		}
+	}
+
+	VL_TARGET_AVX2 static int32_t DotProductAVX2(const uint8_t* input, const int8_t* weights, int size)
+	{
+		const __m256i ones = _mm256_set1_epi16(1);
+		__m256i sum = _mm256_setzero_si256();
+		for (int i = 0; i < size; i += 32)
+		{
+			__m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+		}
+
+		__m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4e));
+		total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xb1));
+		return _mm_cvtsi128_si32(total);
+	}
+#endif
+
+	// `values` = `source` plus the weight rows of `added`, minus the rows of `removed`
+	static void ApplyFeatures(int16_t* values, const int16_t* source, const int16_t* weights,
+		std::span<const int> added, std::span<const int> removed)
+	{
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return ApplyFeaturesAVX2(values, source, weights, added, removed);
+
+		constexpr int VectorCount = AccumulatorSize / 8;
+		__m128i sums[VectorCount];
+		for (int i = 0; i < VectorCount; i++)
+			sums[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 8));
+
+		for (int feature : added)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < VectorCount; i++)
+				sums[i] = _mm_add_epi16(sums[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i * 8)));
+		}
+		for (int feature : removed)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < VectorCount; i++)
+				sums[i] = _mm_sub_epi16(sums[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i * 8)));
+		}
+
+		for (int i = 0; i < VectorCount; i++)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * 8), sums[i]);
+#else
+		if (values != source)
+			std::memcpy(values, source, AccumulatorSize * sizeof(int16_t));
+
+		for (int feature : added)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < AccumulatorSize; i++)
+				values[i] += row[i];
+		}
+		for (int feature : removed)
+		{
+			const int16_t* row = weights + (size_t)feature * AccumulatorSize;
+			for (int i = 0; i < AccumulatorSize; i++)
+				values[i] -= row[i];
+		}
+#endif
+	}
+
+	// Clips one perspective of the accumulator to [0, 127] as the first layer's input
+	static void ClipAccumulator(const int16_t* values, uint8_t* output)
+	{
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return ClipAccumulatorAVX2(values, output);
+
+		const __m128i max = _mm_set1_epi8(127);
+		for (int i = 0; i < AccumulatorSize; i += 16)
+		{
+			__m128i packed = _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 8)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_min_epu8(packed, max));
+		}
+#else
+		for (int i = 0; i < AccumulatorSize; i++)
+			output[i] = (uint8_t)std::clamp<int>(values[i], 0, 127);
+#endif
+	}
+
+	// Inputs are in [0, 127], so the paired products can't saturate 16 bits. `size` is a multiple of 32.
+	static int32_t DotProduct(const uint8_t* input, const int8_t* weights, int size)
+	{
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return DotProductAVX2(input, weights, size);
+
+		// No unsigned by signed byte multiply before SSSE3, so both sides are widened to 16 bits first
+		const __m128i zero = _mm_setzero_si128();
+		__m128i sum = _mm_setzero_si128();
+		for (int i = 0; i < size; i += 16)
+		{
+			__m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+			__m128i weight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+			__m128i weightLow = _mm_srai_epi16(_mm_unpacklo_epi8(weight, weight), 8);
+			__m128i weightHigh = _mm_srai_epi16(_mm_unpackhi_epi8(weight, weight), 8);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(in, zero), weightLow));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpackhi_epi8(in, zero), weightHigh));
+		}
+
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+		return _mm_cvtsi128_si32(sum);
+#else
+		int32_t sum = 0;
+		for (int i = 0; i < size; i++)
+			sum += input[i] * weights[i];
+		return sum;
+#endif
+	}
+
+	// Fully connected layer followed by the clipped ReLU
+	static void AffineTransform(const uint8_t* input, int inputSize, const std::vector<int8_t>& weights,
+		const std::vector<int32_t>& biases, uint8_t* output)
+	{
+		for (int i = 0; i < (int)biases.size(); i++)
+		{
+			int32_t value = biases[i] + DotProduct(input, weights.data() + (size_t)i * inputSize, inputSize);
+			output[i] = (uint8_t)std::clamp(value >> WeightScaleBits, 0, 127);
+		}
+	}
+
+	bool NNUENetwork::Load(const std::string& path)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			std::cerr << "Could not open network " << path << std::endl;
+			return false;
+		}
+
+		// Reads `count` values from the next position, failing once the file runs out
+		size_t offset = 0;
+		bool isTruncated = false;
+		auto read = [&]<typename T>(std::vector<T>& values, size_t count)
+		{
+			if (isTruncated || (file.GetSize() - offset) / sizeof(T) < count)
+			{
+				isTruncated = true;
+				return;
+			}
+			values.resize(count);
+			std::memcpy(values.data(), file.GetData() + offset, count * sizeof(T));
+			offset += count * sizeof(T);
+		};
+
+		std::vector<uint32_t> header;
+		read(header, 3);
+		if (isTruncated || header[0] != NNUEFileVersion)
+		{
+			std::cerr << path << " is not an NNUE network" << std::endl;
+			return false;
+		}
+
+		std::vector<char> description;
+		read(description, header[2]);
+
+		std::vector<uint32_t> hash;
+		std::vector<int16_t> featureBiases, featureWeights;
+		read(hash, 1);
+		read(featureBiases, AccumulatorSize);
+		read(featureWeights, (size_t)FeatureCount * AccumulatorSize);
+
+		std::vector<int32_t> hidden1Biases, hidden2Biases, outputBias;
+		std::vector<int8_t> hidden1Weights, hidden2Weights, outputWeights;
+		read(hash, 1);
+		read(hidden1Biases, HiddenSize);
+		read(hidden1Weights, HiddenSize * 2 * AccumulatorSize);
+		read(hidden2Biases, HiddenSize);
+		read(hidden2Weights, HiddenSize * HiddenSize);
+		read(outputBias, 1);
+		read(outputWeights, HiddenSize);
+
+		if (isTruncated || offset != file.GetSize())
+		{
+			std::cerr << path << " is not a HalfKP 256x2-32-32 network" << std::endl;
+			return false;
+		}
+
+		m_Description.assign(description.begin(), description.end());
+		m_FeatureBiases = std::move(featureBiases);
+		m_FeatureWeights = std::move(featureWeights);
+		m_Hidden1Biases = std::move(hidden1Biases);
+		m_Hidden1Weights = std::move(hidden1Weights);
+		m_Hidden2Biases = std::move(hidden2Biases);
+		m_Hidden2Weights = std::move(hidden2Weights);
+		m_OutputBias = outputBias[0];
+		m_OutputWeights = std::move(outputWeights);
+		return true;
+	}
+
+	void NNUENetwork::Clear()
+	{
+		m_Description.clear();
+		m_FeatureBiases.clear();
+		m_FeatureWeights.clear();
+		m_Hidden1Biases.clear();
+		m_Hidden1Weights.clear();
+		m_Hidden2Biases.clear();
+		m_Hidden2Weights.clear();
+		m_OutputBias = 0;
+		m_OutputWeights.clear();
+	}
+
+	int NNUENetwork::GetFeatureIndex(PieceColor perspective, int kingSquare, PieceType type, PieceColor color, int square)
+	{
+		// Black sees the board rotated, so both perspectives look at it from their own side
+		int flip = perspective == PieceColor::White ? 0 : 63;
+		int piece = 2 * (int)type + (color != perspective);
+		return 1 + (square ^ flip) + 64 * piece + 641 * (kingSquare ^ flip);
+	}
+
+	void NNUENetwork::RefreshAccumulator(NNUEAccumulator& accumulator, int perspective, std::span<const int> features) const
+	{
+		int16_t* values = accumulator.Values[perspective].data();
+		ApplyFeatures(values, m_FeatureBiases.data(), m_FeatureWeights.data(), features, {});
+	}
+
+	void NNUENetwork::UpdateAccumulator(NNUEAccumulator& accumulator, const NNUEAccumulator& source, int perspective,
+		std::span<const int> added, std::span<const int> removed) const
+	{
+		int16_t* values = accumulator.Values[perspective].data();
+		ApplyFeatures(values, source.Values[perspective].data(), m_FeatureWeights.data(), added, removed);
+	}
+
+	int NNUENetwork::Evaluate(const NNUEAccumulator& accumulator, bool isWhiteTurn) const
+	{
+		// The side to move's half comes first
+		alignas(64) uint8_t input[2 * AccumulatorSize];
+		int us = isWhiteTurn ? 0 : 1;
+		ClipAccumulator(accumulator.Values[us].data(), input);
+		ClipAccumulator(accumulator.Values[us ^ 1].data(), input + AccumulatorSize);
+
+		alignas(64) uint8_t hidden1[HiddenSize];
+		alignas(64) uint8_t hidden2[HiddenSize];
+		AffineTransform(input, 2 * AccumulatorSize, m_Hidden1Weights, m_Hidden1Biases, hidden1);
+		AffineTransform(hidden1, HiddenSize, m_Hidden2Weights, m_Hidden2Biases, hidden2);
+
+		int32_t output = m_OutputBias + DotProduct(hidden2, m_OutputWeights.data(), HiddenSize);
+		return output * 100 / (OutputScale * NetworkPawnValue);
+	}
+
+}
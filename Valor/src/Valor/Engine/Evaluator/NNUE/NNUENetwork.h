@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Valor/Chess/Piece.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// Accumulated first layer output for both perspectives, indexed by color (White = 0)
+	struct alignas(64) NNUEAccumulator
+	{
+		constexpr static int Size = 256;
+
+		std::array<std::array<int16_t, Size>, 2> Values;
+	};
+
+	// Quantized HalfKP 256x2-32-32-1 network in the .nnue format: each perspective sees every non-king piece
+	// relative to its own king, the two 256 wide first layer outputs are kept incrementally in an
+	// `NNUEAccumulator`, and the small int8 layers after it run with AVX2 or SSE2 kernels when the build
+	// enables them, or plain loops otherwise. Loading is not thread safe, inference is.
+	class NNUENetwork
+	{
+	public:
+		// Returns false, keeping the previous network, if the file is missing or not a HalfKP 256x2-32-32 network
+		bool Load(const std::string& path);
+		void Clear();
+
+		bool IsLoaded() const { return !m_FeatureBiases.empty(); }
+		const std::string& GetDescription() const { return m_Description; }
+
+		// Feature of a non-king piece seen from `perspective`, whose king is on `kingSquare`
+		static int GetFeatureIndex(PieceColor perspective, int kingSquare, PieceType type, PieceColor color, int square);
+
+		// Sets one perspective of `accumulator` from scratch, or moves it from `source` by the given features
+		void RefreshAccumulator(NNUEAccumulator& accumulator, int perspective, std::span<const int> features) const;
+		void UpdateAccumulator(NNUEAccumulator& accumulator, const NNUEAccumulator& source, int perspective,
+			std::span<const int> added, std::span<const int> removed) const;
+
+		// Score in centipawns from the side to move's point of view
+		int Evaluate(const NNUEAccumulator& accumulator, bool isWhiteTurn) const;
+	public:
+		constexpr static int FeatureCount = 64 * 641;
+		constexpr static int HiddenSize = 32;
+	private:
+		std::string m_Description;
+
+		std::vector<int16_t> m_FeatureBiases;
+		std::vector<int16_t> m_FeatureWeights; // One row of `NNUEAccumulator::Size` weights per feature
+
+		std::vector<int32_t> m_Hidden1Biases;
+		std::vector<int8_t> m_Hidden1Weights; // One row of inputs per output
+		std::vector<int32_t> m_Hidden2Biases;
+		std::vector<int8_t> m_Hidden2Weights;
+		int32_t m_OutputBias = 0;
+		std::vector<int8_t> m_OutputWeights;
+	};
+
+}
@@ -0,0 +1,134 @@
+#include "vlpch.h"
+#include "Valor/Engine/Evaluator/PawnHashTable.h"
+
+#include "Valor/Engine/Evaluator/EvalInfo.h"
+#include "Valor/Engine/SearchStats.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Valor::Engine {
+
+	constexpr TaperedScore DoubledPenalty = { -10, -20 };
+	constexpr TaperedScore IsolatedPenalty = { -10, -15 };
+	constexpr TaperedScore BackwardPenalty = { -8, -10 };
+
+	// By rank, counted from the pawn's own side
+	constexpr TaperedScore PassedBonus[8] = {
+		{ 0, 0 }, { 5, 10 }, { 5, 15 }, { 10, 25 }, { 20, 45 }, { 35, 75 }, { 60, 120 }, { 0, 0 }
+	};
+
+	// By rank of the rearmost own pawn on a file in front of the king, from the king's side; none on the
+	// second to fourth rank counts as an open file
+	constexpr int ShelterPenalty[8] = { -30, 0, -10, -20, -30, -30, -30, -30 };
+
+	static uint64_t NorthFill(uint64_t bitboard)
+	{
+		bitboard |= bitboard << 8;
+		bitboard |= bitboard << 16;
+		return bitboard | bitboard << 32;
+	}
+
+	static uint64_t SouthFill(uint64_t bitboard)
+	{
+		bitboard |= bitboard >> 8;
+		bitboard |= bitboard >> 16;
+		return bitboard | bitboard >> 32;
+	}
+
+	static uint64_t ShiftEast(uint64_t bitboard) { return (bitboard << 1) & ~Board::FileA; }
+	static uint64_t ShiftWest(uint64_t bitboard) { return (bitboard >> 1) & ~Board::FileH; }
+
+	static int GetRelativeRank(int square, bool isWhite) { return isWhite ? square / 8 : 7 - square / 8; }
+
+	static int GetShelterPenalty(uint64_t pawns, int kingFile, bool isWhite)
+	{
+		int penalty = 0;
+		for (int file = std::max(kingFile - 1, 0); file <= std::min(kingFile + 1, 7); file++)
+		{
+			uint64_t filePawns = pawns & (Board::FileA << file);
+			if (!filePawns)
+			{
+				penalty += ShelterPenalty[0];
+				continue;
+			}
+
+			int square = isWhite ? std::countr_zero(filePawns) : 63 - std::countl_zero(filePawns);
+			penalty += ShelterPenalty[GetRelativeRank(square, isWhite)];
+		}
+		return penalty;
+	}
+
+	void PawnStructure::Evaluate(const Board& board, PawnEntry& entry)
+	{
+		entry = {};
+
+		for (int color = 0; color < 2; color++)
+		{
+			bool isWhite = color == 0;
+			uint64_t own = board.Pawns(isWhite);
+			uint64_t enemy = board.Pawns(!isWhite);
+
+			// Squares in front of each side's pawns, from this side's point of view
+			uint64_t ownFront = isWhite ? NorthFill(own) << 8 : SouthFill(own) >> 8;
+			uint64_t enemyFront = isWhite ? SouthFill(enemy) >> 8 : NorthFill(enemy) << 8;
+
+			entry.PawnAttacks[color] = EvalInfo::GetPawnAttacks(own, isWhite);
+			entry.AttackSpans[color] = EvalInfo::GetPawnAttacks(own | ownFront, isWhite);
+			entry.PassedPawns[color] = own & ~(enemyFront | ShiftEast(enemyFront) | ShiftWest(enemyFront));
+
+			TaperedScore score;
+
+			// Every pawn with another one behind it on its file
+			score += DoubledPenalty * std::popcount(own & ownFront);
+
+			uint64_t files = NorthFill(SouthFill(own));
+			score += IsolatedPenalty * std::popcount(own & ~ShiftEast(files) & ~ShiftWest(files));
+
+			// Can't advance without being taken, and no pawn on a neighbouring file can come up to defend it
+			uint64_t stops = isWhite ? own << 8 : own >> 8;
+			uint64_t enemyAttacks = EvalInfo::GetPawnAttacks(enemy, !isWhite);
+			score += BackwardPenalty * std::popcount(stops & enemyAttacks & ~entry.AttackSpans[color]);
+
+			uint64_t passed = entry.PassedPawns[color];
+			while (passed)
+			{
+				score += PassedBonus[GetRelativeRank(std::countr_zero(passed), isWhite)];
+				passed &= passed - 1;
+			}
+
+			if (isWhite)
+				entry.Score += score;
+			else
+				entry.Score -= score;
+
+			// Only pawns on the second to fourth rank shelter the king
+			uint64_t shelterRanks = isWhite ? 0x00000000ffffff00ull : 0x00ffffff00000000ull;
+			for (int file = 0; file < 8; file++)
+				entry.Shelter[color][file] = (int16_t)GetShelterPenalty(own & shelterRanks, file, isWhite);
+		}
+	}
+
+	const PawnEntry& PawnHashTable::Probe(const Board& board)
+	{
+		uint64_t key = board.GetPawnHash();
+		PawnEntry& entry = m_Entries[key & (PawnTableSize - 1)];
+
+		VL_STATS(m_Probes++);
+		if (entry.Key == key)
+		{
+			VL_STATS(m_Hits++);
+			return entry;
+		}
+
+		PawnStructure::Evaluate(board, entry);
+		entry.Key = key;
+		return entry;
+	}
+
+	void PawnHashTable::Clear()
+	{
+		std::fill(m_Entries.begin(), m_Entries.end(), PawnEntry{});
+	}
+
+}
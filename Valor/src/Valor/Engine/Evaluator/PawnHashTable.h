@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Chess/PieceSquareTables.h"
+
+#include <array>
+#include <cstdint>
+#include <xmmintrin.h>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// Everything the evaluation derives from the pawns alone. Bitboards are indexed by color (White = 0).
+	struct PawnEntry
+	{
+		uint64_t Key = 0;
+
+		// Passed, isolated, doubled and backward pawns, White minus Black
+		TaperedScore Score;
+
+		std::array<uint64_t, 2> PassedPawns = {};
+		std::array<uint64_t, 2> PawnAttacks = {};
+		std::array<uint64_t, 2> AttackSpans = {}; // Squares the pawns attack now or could after advancing
+
+		// Midgame penalty for the pawns in front of a king castled on each file, as a negative score
+		std::array<std::array<int16_t, 8>, 2> Shelter = {};
+	};
+
+	namespace PawnStructure {
+
+		void Evaluate(const Board& board, PawnEntry& entry);
+
+	}
+
+	// Caches `PawnEntry`s by the board's pawn key. Pawn structures repeat across most of a search, so nearly
+	// every evaluation is a single probe. Not thread safe; each search thread needs its own.
+	class PawnHashTable
+	{
+	public:
+		PawnHashTable() : m_Entries(PawnTableSize) {}
+
+		const PawnEntry& Probe(const Board& board);
+
+		// Starts loading the board's entry into the cache, for a probe shortly after
+		void Prefetch(const Board& board) const
+		{
+			_mm_prefetch(reinterpret_cast<const char*>(&m_Entries[board.GetPawnHash() & (PawnTableSize - 1)]), _MM_HINT_T0);
+		}
+		void Clear();
+
+		// Probes since construction, and how many found their entry. Zero with search statistics compiled out.
+		uint64_t GetProbes() const { return m_Probes; }
+		uint64_t GetHits() const { return m_Hits; }
+	public:
+		constexpr static size_t PawnTableSize = 1 << 14; // Entries, a power of two
+	private:
+		std::vector<PawnEntry> m_Entries;
+		uint64_t m_Probes = 0;
+		uint64_t m_Hits = 0;
+	};
+
+}
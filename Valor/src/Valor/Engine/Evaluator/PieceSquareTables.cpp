@@ -0,0 +1,43 @@
+#include "vlpch.h"
+#include "Valor/Chess/PieceSquareTables.h"
+
+#include "Valor/Engine/Evaluator/EvalParameters.h"
+#include "Valor/Engine/Evaluator/Evaluator.h"
+
+#include <array>
+
+// The board keeps these entries summed up, but their values come from the evaluator's parameters
+namespace Valor::PieceSquareTables {
+
+	constexpr int PieceValues[6] = { Engine::PawnValue, Engine::KnightValue, Engine::BishopValue, Engine::RookValue, Engine::QueenValue, 0 };
+	constexpr int PhaseWeights[6] = { 0, 1, 1, 2, 4, 0 };
+
+	constexpr EntryTable Entries = []()
+	{
+		EntryTable entries = {};
+		for (int type = 0; type < 6; type++)
+		{
+			for (int color = 0; color < 2; color++)
+			{
+				int sign = color == 0 ? 1 : -1;
+				for (int square = 0; square < 64; square++)
+				{
+					// Tables are written from White's point of view with rank 8 on top, so a white piece's
+					// square is flipped vertically to index them and a black piece's square indexes them as is
+					int index = color == 0 ? square ^ 56 : square;
+
+					// Material counts the fixed piece values, the bonus makes up the difference to the tuned ones
+					const TaperedScore& value = Engine::EvalParameters::PieceValues[type];
+					TaperedScore bonus = {
+						Engine::EvalParameters::MidgameTables[type][index] + value.Midgame - PieceValues[type],
+						Engine::EvalParameters::EndgameTables[type][index] + value.Endgame - PieceValues[type]
+					};
+
+					entries[type][color][square] = { sign * PieceValues[type], { sign * bonus.Midgame, sign * bonus.Endgame }, PhaseWeights[type] };
+				}
+			}
+		}
+		return entries;
+	}();
+
+}
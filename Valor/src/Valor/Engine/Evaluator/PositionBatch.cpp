@@ -0,0 +1,219 @@
+#include "vlpch.h"
+#include "Valor/Engine/Evaluator/PositionBatch.h"
+
+#include "Valor/Core/CPUFeatures.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(VL_X86_64)
+	#include <immintrin.h>
+#endif
+
+namespace Valor::Engine {
+
+	// Positions per vector of bitboards, and per vector of 32 bit scores. The loops run over whole vectors,
+	// with the lanes past `Count` zeroed.
+	constexpr size_t LaneWidth = 4;
+	constexpr size_t ScoreLaneWidth = 8;
+
+	static size_t RoundUpToLanes(size_t count)
+	{
+		return (count + ScoreLaneWidth - 1) / ScoreLaneWidth * ScoreLaneWidth;
+	}
+
+#if defined(VL_X86_64)
+	// The AVX2 versions are picked at runtime on CPUs that have it; the plain loops run everywhere else
+	static const bool UseAVX2 = HasAVX2();
+
+	VL_TARGET_AVX2 static __m256i LoadLanes(const uint64_t* data) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(data)); }
+	VL_TARGET_AVX2 static void StoreLanes(uint64_t* data, __m256i value) { _mm256_store_si256(reinterpret_cast<__m256i*>(data), value); }
+
+	// ~a & b
+	VL_TARGET_AVX2 static __m256i AndNot(__m256i a, __m256i b) { return _mm256_andnot_si256(a, b); }
+
+	// Bits set in each 64 bit lane, by looking up both nibbles of every byte and summing the bytes
+	VL_TARGET_AVX2 static __m256i PopCount(__m256i value)
+	{
+		const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+
+		__m256i low = _mm256_and_si256(value, lowNibbles);
+		__m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibbles);
+		__m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(nibbleCounts, low), _mm256_shuffle_epi8(nibbleCounts, high));
+		return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+	}
+
+	VL_TARGET_AVX2 static void ComputeAttackMapsAVX2(PositionBatch& batch, size_t count)
+	{
+		const __m256i fileA = _mm256_set1_epi64x((long long)Board::FileA);
+		const __m256i fileH = _mm256_set1_epi64x((long long)Board::FileH);
+
+		for (size_t i = 0; i < count; i += LaneWidth)
+		{
+			for (int color = 0; color < 2; color++)
+			{
+				__m256i pawns = LoadLanes(&batch.Pawns[color][i]);
+				__m256i towardsA = AndNot(fileA, pawns);
+				__m256i towardsH = AndNot(fileH, pawns);
+				__m256i pawnAttacks = color == 0
+					? _mm256_or_si256(_mm256_slli_epi64(towardsA, 7), _mm256_slli_epi64(towardsH, 9))
+					: _mm256_or_si256(_mm256_srli_epi64(towardsA, 9), _mm256_srli_epi64(towardsH, 7));
+				StoreLanes(&batch.PawnAttacks[color][i], pawnAttacks);
+
+				// The king's neighbours on its rank, then the ranks above and below those and the king
+				__m256i king = LoadLanes(&batch.Kings[color][i]);
+				__m256i sides = _mm256_or_si256(_mm256_srli_epi64(AndNot(fileA, king), 1), _mm256_slli_epi64(AndNot(fileH, king), 1));
+				__m256i rank = _mm256_or_si256(king, sides);
+				__m256i kingAttacks = _mm256_or_si256(sides, _mm256_or_si256(_mm256_slli_epi64(rank, 8), _mm256_srli_epi64(rank, 8)));
+				StoreLanes(&batch.KingAttacks[color][i], kingAttacks);
+				StoreLanes(&batch.KingZone[color][i], _mm256_or_si256(kingAttacks, king));
+			}
+
+			for (int color = 0; color < 2; color++)
+			{
+				__m256i blocked = _mm256_or_si256(LoadLanes(&batch.Pieces[color][i]), LoadLanes(&batch.PawnAttacks[color ^ 1][i]));
+				StoreLanes(&batch.MobilityArea[color][i], _mm256_xor_si256(blocked, _mm256_set1_epi64x(-1)));
+			}
+		}
+	}
+
+	VL_TARGET_AVX2 static void AddSafeSquaresAVX2(PositionBatch& batch, size_t count, const std::array<uint64_t, 2>& masks, int weight)
+	{
+		const __m256i whiteMask = _mm256_set1_epi64x((long long)masks[0]);
+		const __m256i blackMask = _mm256_set1_epi64x((long long)masks[1]);
+		const __m128i weights = _mm_set1_epi32(weight);
+
+		// Takes the low half of each 64 bit count
+		const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+
+		for (size_t i = 0; i < count; i += LaneWidth)
+		{
+			__m256i white = AndNot(_mm256_or_si256(LoadLanes(&batch.Pawns[0][i]), LoadLanes(&batch.PawnAttacks[1][i])), whiteMask);
+			__m256i black = AndNot(_mm256_or_si256(LoadLanes(&batch.Pawns[1][i]), LoadLanes(&batch.PawnAttacks[0][i])), blackMask);
+			__m256i difference = _mm256_sub_epi64(PopCount(white), PopCount(black));
+
+			__m128i counts = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(difference, lowHalves));
+			__m128i* midgame = reinterpret_cast<__m128i*>(&batch.Midgame[i]);
+			_mm_store_si128(midgame, _mm_add_epi32(_mm_load_si128(midgame), _mm_mullo_epi32(counts, weights)));
+		}
+	}
+
+	VL_TARGET_AVX2 static void BlendAVX2(const PositionBatch& batch, size_t count, std::span<int> scores)
+	{
+		const __m256i maxPhase = _mm256_set1_epi32(MaxGamePhase);
+		const __m256d divisor = _mm256_set1_pd(MaxGamePhase);
+
+		// Eight positions at a time; the division goes through doubles, which hold every sum exactly
+		// and truncate the same way integer division does
+		alignas(32) PositionBatch::Lanes<int32_t> blended;
+		for (size_t i = 0; i < count; i += ScoreLaneWidth)
+		{
+			__m256i phase = _mm256_load_si256(reinterpret_cast<const __m256i*>(&batch.Phase[i]));
+			phase = _mm256_min_epi32(_mm256_max_epi32(phase, _mm256_setzero_si256()), maxPhase);
+
+			__m256i midgame = _mm256_load_si256(reinterpret_cast<const __m256i*>(&batch.Midgame[i]));
+			__m256i endgame = _mm256_load_si256(reinterpret_cast<const __m256i*>(&batch.Endgame[i]));
+			__m256i sum = _mm256_add_epi32(_mm256_mullo_epi32(midgame, phase),
+				_mm256_mullo_epi32(endgame, _mm256_sub_epi32(maxPhase, phase)));
+
+			__m128i low = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(sum)), divisor));
+			__m128i high = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(sum, 1)), divisor));
+
+			__m256i score = _mm256_load_si256(reinterpret_cast<const __m256i*>(&batch.Score[i]));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&blended[i]), _mm256_add_epi32(score, _mm256_set_m128i(high, low)));
+		}
+		std::copy_n(blended.begin(), count, scores.begin());
+	}
+#endif
+
+	void PositionBatch::Load(std::span<const Board> boards)
+	{
+		Count = std::min(boards.size(), Size);
+		for (size_t i = 0; i < Count; i++)
+		{
+			const Board& board = boards[i];
+			for (int color = 0; color < 2; color++)
+			{
+				bool isWhite = color == 0;
+				Pieces[color][i] = board.AllPieces(isWhite);
+				Pawns[color][i] = board.Pawns(isWhite);
+				Kings[color][i] = board.Kings(isWhite);
+			}
+
+			Phase[i] = board.GetGamePhase();
+			Score[i] = board.GetMaterial();
+			Midgame[i] = board.GetPieceSquareScore().Midgame;
+			Endgame[i] = board.GetPieceSquareScore().Endgame;
+		}
+
+		for (size_t i = Count; i < RoundUpToLanes(Count); i++)
+		{
+			for (int color = 0; color < 2; color++)
+				Pieces[color][i] = Pawns[color][i] = Kings[color][i] = 0;
+			Phase[i] = Score[i] = Midgame[i] = Endgame[i] = 0;
+		}
+	}
+
+	void PositionBatch::ComputeAttackMaps()
+	{
+		size_t count = RoundUpToLanes(Count);
+
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return ComputeAttackMapsAVX2(*this, count);
+#endif
+
+		for (size_t i = 0; i < count; i++)
+		{
+			for (int color = 0; color < 2; color++)
+			{
+				uint64_t pawns = Pawns[color][i];
+				PawnAttacks[color][i] = color == 0
+					? ((pawns & ~Board::FileA) << 7) | ((pawns & ~Board::FileH) << 9)
+					: ((pawns & ~Board::FileA) >> 9) | ((pawns & ~Board::FileH) >> 7);
+
+				uint64_t king = Kings[color][i];
+				uint64_t sides = ((king & ~Board::FileA) >> 1) | ((king & ~Board::FileH) << 1);
+				uint64_t rank = king | sides;
+				KingAttacks[color][i] = sides | (rank << 8) | (rank >> 8);
+				KingZone[color][i] = KingAttacks[color][i] | king;
+			}
+
+			for (int color = 0; color < 2; color++)
+				MobilityArea[color][i] = ~(Pieces[color][i] | PawnAttacks[color ^ 1][i]);
+		}
+	}
+
+	void PositionBatch::AddSafeSquares(const std::array<uint64_t, 2>& masks, int weight)
+	{
+		size_t count = RoundUpToLanes(Count);
+
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return AddSafeSquaresAVX2(*this, count, masks, weight);
+#endif
+
+		for (size_t i = 0; i < count; i++)
+		{
+			int difference = std::popcount(masks[0] & ~Pawns[0][i] & ~PawnAttacks[1][i])
+				- std::popcount(masks[1] & ~Pawns[1][i] & ~PawnAttacks[0][i]);
+			Midgame[i] += weight * difference;
+		}
+	}
+
+	void PositionBatch::Blend(std::span<int> scores) const
+	{
+		size_t count = std::min(Count, scores.size());
+
+#if defined(VL_X86_64)
+		if (UseAVX2)
+			return BlendAVX2(*this, count, scores);
+#endif
+
+		for (size_t i = 0; i < count; i++)
+			scores[i] = Score[i] + TaperedScore{ Midgame[i], Endgame[i] }.Blend(Phase[i]);
+	}
+
+}
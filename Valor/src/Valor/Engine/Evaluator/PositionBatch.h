@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace Valor::Engine {
+
+	// Up to `Size` positions laid out structure-of-arrays, so the evaluation terms that only combine a few
+	// bitboards are computed for several positions at once: four per instruction with AVX2. Arrays are
+	// indexed by color (White = 0) where they have one, then by position.
+	struct PositionBatch
+	{
+		constexpr static size_t Size = 64;
+
+		template<typename T>
+		using Lanes = std::array<T, Size>;
+
+		size_t Count = 0;
+
+		// Filled by `Load`
+		alignas(32) std::array<Lanes<uint64_t>, 2> Pieces;
+		alignas(32) std::array<Lanes<uint64_t>, 2> Pawns;
+		alignas(32) std::array<Lanes<uint64_t>, 2> Kings;
+		alignas(32) Lanes<int32_t> Phase;
+
+		// Evaluation terms, White minus Black, summed until `Blend` combines them. `Load` starts them at the
+		// material and piece-square bonuses, the evaluator adds the rest.
+		alignas(32) Lanes<int32_t> Score;
+		alignas(32) Lanes<int32_t> Midgame;
+		alignas(32) Lanes<int32_t> Endgame;
+
+		// Filled by `ComputeAttackMaps`. King attacks and zone are empty for a side without a king.
+		alignas(32) std::array<Lanes<uint64_t>, 2> PawnAttacks;
+		alignas(32) std::array<Lanes<uint64_t>, 2> KingAttacks;
+		alignas(32) std::array<Lanes<uint64_t>, 2> KingZone;
+		alignas(32) std::array<Lanes<uint64_t>, 2> MobilityArea;
+
+		// The first `Size` boards at most
+		void Load(std::span<const Board> boards);
+
+		void ComputeAttackMaps();
+
+		// Adds `weight` per square of `masks[color]` holding no own pawn and not attacked by an enemy pawn to
+		// the midgame term, White's squares minus Black's. Needs the attack maps.
+		void AddSafeSquares(const std::array<uint64_t, 2>& masks, int weight);
+
+		// Each position's score: the untapered terms plus the tapered ones blended by phase, the same as
+		// `TaperedScore::Blend` would. Writes `Count` scores.
+		void Blend(std::span<int> scores) const;
+	};
+
+}
@@ -1,110 +1,250 @@
 #include "vlpch.h"
 #include "Valor/Engine/Evaluator/Evaluator.h"
 
-#include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
-
-#include <vector>
+#include "Valor/Chess/MoveGeneration/MagicBitboard.h"
+#include "Valor/Engine/Evaluator/EvalInfo.h"
+#include "Valor/Engine/Evaluator/PawnHashTable.h"
+#include "Valor/Engine/Evaluator/PositionBatch.h"
+
+#include <algorithm>
+#include <bit>
 
 namespace Valor::Engine {
 
-	// Piece-square tables
-	constexpr int PawnTable[64] = {
-		 0,   5,  10,  20,  20,  10,   5,   0,
-		 0,  10,  15,  25,  25,  15,  10,   0,
-		 0,   5,  10,  20,  20,  10,   5,   0,
-		 0,   0,   0,  15,  15,   0,   0,   0,
-		 5,   5,   0, -10, -10,   0,   5,   5,
-		 5,  10,  10, -20, -20,  10,  10,   5,
-		10,  10,  20, -30, -30,  20,  10,  10,
-		 0,   0,   0,   0,   0,   0,   0,   0
-	};
-
-	constexpr int KnightTable[64] = {
-		-50, -40, -30, -30, -30, -30, -40, -50,
-		-40, -20,   0,   0,   0,   0, -20, -40,
-		-30,   0,  10,  15,  15,  10,   0, -30,
-		-30,   5,  15,  20,  20,  15,   5, -30,
-		-30,   0,  15,  20,  20,  15,   0, -30,
-		-30,   5,  10,  15,  15,  10,   5, -30,
-		-40, -20,   0,   5,   5,   0, -20, -40,
-		-50, -40, -30, -30, -30, -30, -40, -50
-	};
-
-	constexpr int KingSafetyTable[64] = {
-	   -30, -40, -40, -50, -50, -40, -40, -30,
-	   -30, -40, -40, -50, -50, -40, -40, -30,
-	   -30, -40, -40, -50, -50, -40, -40, -30,
-	   -30, -40, -40, -50, -50, -40, -40, -30,
-	   -20, -30, -30, -40, -40, -30, -30, -20,
-	   -10, -20, -20, -20, -20, -20, -20, -10,
-		20,  20,   0,   0,   0,   0,  20,  20,
-		20,  30,  10,   0,   0,  10,  30,  20
-	};
-
-	// Mobility weight
+	// Mobility weight, per safe square attacked
 	constexpr int MobilityWeight = 2;
 
-	// Helper function to get square index from rank/file
-	inline int GetSquareIndex(int rank, int file) {
-		return rank * 8 + file;
+	// What each piece type attacking the enemy king zone adds to the attack, and the percentage of that
+	// sum which counts for a given number of attackers, since a lone attacker is rarely dangerous
+	constexpr int KingAttackWeights[6] = { 0, 20, 20, 40, 80, 0 };
+	constexpr int KingAttackScale[8] = { 0, 0, 50, 75, 88, 94, 97, 99 };
+
+	// Enemy pieces attacked by a pawn, and enemy pieces attacked but not defended
+	constexpr int PawnThreatBonus = 40;
+	constexpr int HangingPieceBonus = 20;
+
+	// Safe squares in the centre files on a side's own half, behind or beside its pawns
+	constexpr uint64_t CenterFiles = 0x3c3c3c3c3c3c3c3cull;
+	constexpr std::array<uint64_t, 2> SpaceMasks = { CenterFiles & 0x00000000ffffff00ull, CenterFiles & 0x00ffffff00000000ull };
+	constexpr int SpaceWeight = 2;
+
+	// Knights on the enemy half, defended by a pawn and out of reach of enemy pawns
+	constexpr TaperedScore KnightOutpostBonus = { 20, 10 };
+
+	// Per rank from the pawn's own side, for a passed pawn whose next square is empty and not attacked
+	constexpr TaperedScore FreePassedPawnBonus = { 0, 5 };
+
+	// How far the terms after material and piece-square bonuses may move the score, for lazy evaluation.
+	// Searched positions stay within about 225 of it.
+	constexpr int LazyMargin = 300;
+
+	static uint64_t GetPieceAttacks(PieceType type, int square, uint64_t occupied)
+	{
+		switch (type)
+		{
+		case PieceType::Knight: return MagicBitboard::GetKnightAttacks(square);
+		case PieceType::Bishop: return MagicBitboard::GetBishopAttacks(square, occupied);
+		case PieceType::Rook: return MagicBitboard::GetRookAttacks(square, occupied);
+		case PieceType::Queen: return MagicBitboard::GetQueenAttacks(square, occupied);
+		default: return 0;
+		}
+	}
+
+	// Adds the side's piece attacks to `info` and returns its mobility
+	static int EvaluatePieces(const Board& board, EvalInfo& info, int color)
+	{
+		bool isWhite = color == 0;
+		uint64_t occupied = board.Occupied();
+		uint64_t enemyKingZone = info.KingZone[color ^ 1];
+
+		int mobility = 0;
+		for (PieceType type : { PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen })
+		{
+			uint64_t pieces = board.GetPieceBitboard(isWhite, type);
+			while (pieces)
+			{
+				int square = std::countr_zero(pieces);
+				pieces &= pieces - 1;
+
+				uint64_t attacks = GetPieceAttacks(type, square, occupied);
+				info.AddAttacks(color, type, attacks);
+				mobility += std::popcount(attacks & info.MobilityArea[color]);
+
+				if (attacks & enemyKingZone)
+				{
+					info.KingAttackerCount[color ^ 1]++;
+					info.KingAttackWeight[color ^ 1] += KingAttackWeights[(int)type];
+				}
+			}
+		}
+
+		return mobility * MobilityWeight;
+	}
+
+	// Penalty for the attack on the side's king
+	static int EvaluateKingSafety(const EvalInfo& info, int color)
+	{
+		int attackers = std::min(info.KingAttackerCount[color], 7);
+		return -info.KingAttackWeight[color] * KingAttackScale[attackers] / 100;
+	}
+
+	static int EvaluateThreats(const Board& board, const EvalInfo& info, int color)
+	{
+		uint64_t enemies = board.AllPieces(color != 0) & ~board.Kings();
+		uint64_t pawnThreats = enemies & ~board.Pawns() & info.Attacks[color][(int)PieceType::Pawn];
+		uint64_t hanging = enemies & info.AllAttacks[color] & ~info.AllAttacks[color ^ 1];
+		return PawnThreatBonus * std::popcount(pawnThreats) + HangingPieceBonus * std::popcount(hanging);
+	}
+
+	static int EvaluateSpace(const Board& board, const EvalInfo& info, int color)
+	{
+		uint64_t safe = SpaceMasks[color] & ~board.Pawns(color == 0) & ~info.Attacks[color ^ 1][(int)PieceType::Pawn];
+		return SpaceWeight * std::popcount(safe);
+	}
+
+	// Pawn cover of a king that is still on its first two ranks
+	static int EvaluateShelter(const Board& board, const PawnEntry& pawns, int color)
+	{
+		bool isWhite = color == 0;
+		int kingSquare = board.GetKingSquare(isWhite);
+		if (kingSquare == 64 || (isWhite ? kingSquare / 8 : 7 - kingSquare / 8) > 1)
+			return 0;
+
+		return pawns.Shelter[color][kingSquare % 8];
+	}
+
+	static TaperedScore EvaluateOutposts(const Board& board, const PawnEntry& pawns, int color)
+	{
+		uint64_t enemyHalf = color == 0 ? 0xffffffff00000000ull : 0x00000000ffffffffull;
+		uint64_t outposts = enemyHalf & pawns.PawnAttacks[color] & ~pawns.AttackSpans[color ^ 1];
+		return KnightOutpostBonus * std::popcount(board.Knights(color == 0) & outposts);
+	}
+
+	static TaperedScore EvaluatePassedPawns(const Board& board, const EvalInfo& info, const PawnEntry& pawns, int color)
+	{
+		bool isWhite = color == 0;
+		uint64_t passed = pawns.PassedPawns[color];
+		uint64_t stops = isWhite ? passed << 8 : passed >> 8;
+		uint64_t freeStops = stops & ~board.Occupied() & ~info.AllAttacks[color ^ 1];
+
+		TaperedScore score;
+		while (freeStops)
+		{
+			int square = std::countr_zero(freeStops);
+			freeStops &= freeStops - 1;
+			score += FreePassedPawnBonus * (isWhite ? square / 8 - 1 : 6 - square / 8);
+		}
+		return score;
+	}
+
+	// Everything but material, piece-square bonuses and space, once `info` holds the pawn and king attacks.
+	// Returns the untapered terms and adds the tapered ones to `tapered`.
+	static int EvaluateAttackTerms(const Board& board, EvalInfo& info, const PawnEntry& pawns, TaperedScore& tapered)
+	{
+		// Both sides' attacks have to be in before the terms below read them
+		int score = EvaluatePieces(board, info, 0) - EvaluatePieces(board, info, 1);
+		score += EvaluateThreats(board, info, 0) - EvaluateThreats(board, info, 1);
+
+		tapered += pawns.Score;
+		tapered += EvaluateOutposts(board, pawns, 0);
+		tapered -= EvaluateOutposts(board, pawns, 1);
+		tapered += EvaluatePassedPawns(board, info, pawns, 0);
+		tapered -= EvaluatePassedPawns(board, info, pawns, 1);
+
+		// King safety and shelter only matter with pieces on the board
+		tapered.Midgame += EvaluateKingSafety(info, 0) - EvaluateKingSafety(info, 1);
+		tapered.Midgame += EvaluateShelter(board, pawns, 0) - EvaluateShelter(board, pawns, 1);
+		return score;
 	}
 
-	// Compute mobility score
-	int GetMobilityScore(const Board& board, const Valor::Piece& piece, int square)
+	// What `EvalInfo(board)` starts with, from the batch's attack maps
+	static EvalInfo GetEvalInfo(const PositionBatch& batch, size_t index)
 	{
-		std::vector<Move> moves = MoveGeneratorSimple::GenerateMovesForPiece(board, square, piece);
-		return moves.size() * MobilityWeight;
+		EvalInfo info;
+		for (int color = 0; color < 2; color++)
+		{
+			info.AddAttacks(color, PieceType::Pawn, batch.PawnAttacks[color][index]);
+			info.AddAttacks(color, PieceType::King, batch.KingAttacks[color][index]);
+			info.KingZone[color] = batch.KingZone[color][index];
+			info.MobilityArea[color] = batch.MobilityArea[color][index];
+		}
+		return info;
 	}
 
 	// Evaluate function
 	int PositionalEvaluator::Evaluate(const Board& board)
 	{
-		int score = 0;
+		bool isExact;
+		return EvaluateLazy(board, -MateScore, MateScore, isExact);
+	}
+
+	int PositionalEvaluator::EvaluateLazy(const Board& board, int alpha, int beta, bool& isExact)
+	{
+		// Material and piece-square bonuses are kept up to date by the board
+		int phase = board.GetGamePhase();
+		int score = board.GetMaterial();
+		TaperedScore tapered = board.GetPieceSquareScore();
 
-		for (int square = 0; square < 64; ++square)
-		{
-			Valor::Piece piece = board.GetPiece(square);
-			if (piece.Type == Valor::PieceType::None) continue;
+		// Nothing below can bring a score this far outside the window back into it
+		int partial = score + tapered.Blend(phase);
+		isExact = false;
+		if (partial + LazyMargin <= alpha)
+			return partial + LazyMargin;
+		if (partial - LazyMargin >= beta)
+			return partial - LazyMargin;
+		isExact = true;
+
+		PawnEntry uncachedPawns;
+		EvalInfo info(board);
+		score += EvaluateAttackTerms(board, info, ProbePawns(board, uncachedPawns), tapered);
+
+		// Space only matters with pieces on the board
+		tapered.Midgame += EvaluateSpace(board, info, 0) - EvaluateSpace(board, info, 1);
 
-			int pieceValue = 0;
-			int positionBonus = 0;
-			int mobilityBonus = GetMobilityScore(board, piece, square);
+		return score + tapered.Blend(phase);
+	}
+
+	void PositionalEvaluator::EvaluateBatch(std::span<const Board> boards, std::span<int> scores)
+	{
+		PositionBatch batch;
+		PawnEntry uncachedPawns;
+		for (size_t first = 0; first < boards.size(); first += PositionBatch::Size)
+		{
+			batch.Load(boards.subspan(first));
+			batch.ComputeAttackMaps();
+			batch.AddSafeSquares(SpaceMasks, SpaceWeight);
 
-			switch (piece.Type)
+			// The pawn entries are probed below, in order
+			if (m_PawnTable)
 			{
-			case Valor::PieceType::Pawn:
-				pieceValue = PawnValue;
-				positionBonus = PawnTable[square];
-				break;
-			case Valor::PieceType::Knight:
-				pieceValue = KnightValue;
-				positionBonus = KnightTable[square];
-				break;
-			case Valor::PieceType::Bishop:
-				pieceValue = BishopValue;
-				break;
-			case Valor::PieceType::Rook:
-				pieceValue = RookValue;
-				break;
-			case Valor::PieceType::Queen:
-				pieceValue = QueenValue;
-				break;
-			case Valor::PieceType::King:
-				positionBonus = KingSafetyTable[square];
-				break;
-			default:
-				break;
+				for (size_t i = 0; i < batch.Count; i++)
+					m_PawnTable->Prefetch(boards[first + i]);
 			}
 
-			int pieceScore = pieceValue + positionBonus + mobilityBonus;
+			// Piece attacks are magic lookups square by square, so the rest goes one position at a time
+			for (size_t i = 0; i < batch.Count; i++)
+			{
+				const Board& board = boards[first + i];
+				EvalInfo info = GetEvalInfo(batch, i);
+
+				TaperedScore tapered;
+				batch.Score[i] += EvaluateAttackTerms(board, info, ProbePawns(board, uncachedPawns), tapered);
+				batch.Midgame[i] += tapered.Midgame;
+				batch.Endgame[i] += tapered.Endgame;
+			}
 
-			if (piece.Color == Valor::PieceColor::White)
-				score += pieceScore;
-			else
-				score -= pieceScore;
+			batch.Blend(scores.subspan(first));
 		}
+	}
 
-		return score;
+	// Pawn structure rarely changes between nodes, so with a pawn table it's almost always one probe
+	const PawnEntry& PositionalEvaluator::ProbePawns(const Board& board, PawnEntry& uncached) const
+	{
+		if (m_PawnTable)
+			return m_PawnTable->Probe(board);
+
+		PawnStructure::Evaluate(board, uncached);
+		return uncached;
 	}
-
+
 }
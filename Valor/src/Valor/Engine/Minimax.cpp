@@ -2,80 +2,639 @@
 #include "Valor/Engine/Minimax.h"
 
 #include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUEEvaluator.h"
+#include "Valor/Engine/MoveOrdering.h"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
 
 namespace Valor::Engine {
 
-	Move Minimax::FindBestMove(Board& board, int maxDepth, Evaluator* evaluator)
+	constexpr int MateThreshold = MateScore - MaxPly;
+	constexpr int DrawScore = 0;
+
+	// Tablebase wins rank below every mate, and like mates lose a point per ply to reach them
+	constexpr int TablebaseWinScore = MateThreshold - 1;
+	constexpr int TablebaseWinThreshold = TablebaseWinScore - MaxPly;
+
+	// Tablebase results are exact, so they are stored as if searched this much deeper
+	constexpr int TablebaseDepthBonus = 6;
+
+	// Positions further back than this are cut off by the fifty-move rule
+	constexpr size_t MaxReversiblePlies = 100;
+
+	// Keeps the evaluator on the searched path while the search is inside `child`
+	template<SearchEvaluator TEvaluator>
+	class EvaluatorMoveScope
 	{
-		m_MaxDepth = maxDepth;
-		m_Evaluator = evaluator;
+	public:
+		EvaluatorMoveScope(TEvaluator& evaluator, const Board& parent, const Board& child)
+			: m_Evaluator(evaluator)
+		{
+			m_Evaluator.OnMakeMove(parent, child);
+		}
+		~EvaluatorMoveScope() { m_Evaluator.OnUnmakeMove(); }
+
+		EvaluatorMoveScope(const EvaluatorMoveScope&) = delete;
+		EvaluatorMoveScope& operator=(const EvaluatorMoveScope&) = delete;
+	private:
+		TEvaluator& m_Evaluator;
+	};
+
+	// Selective search parameters
+	constexpr int NullMoveMinDepth = 3;
+	constexpr int NullMoveVerificationMaterial = RookValue; // Verify null move cutoffs at or below this much material
+	constexpr int ReverseFutilityDepth = 6;
+	constexpr int ReverseFutilityMargin = 90;
+	constexpr int FutilityDepth = 3;
+	constexpr int FutilityMargin = 120;
+	constexpr int LateMovePruningDepth = 4;
+	constexpr int LateMoveReductionDepth = 3;
+	constexpr int LateMoveReductionMinMoves = 3;
+
+	// Aspiration windows
+	constexpr int AspirationMinDepth = 4;
+	constexpr int AspirationWindow = 50;
+
+	// Logarithmic late move reductions, indexed by [depth][move number]
+	static const std::array<std::array<int, 64>, MaxPly> s_Reductions = []()
+	{
+		std::array<std::array<int, 64>, MaxPly> reductions = {};
+		for (int depth = 1; depth < MaxPly; depth++)
+			for (int moveNumber = 1; moveNumber < 64; moveNumber++)
+				reductions[depth][moveNumber] = (int)(0.75 + std::log(depth) * std::log(moveNumber) / 2.25);
+		return reductions;
+	}();
+
+	static int NonPawnMaterial(const Board& board, bool isWhite)
+	{
+		return KnightValue * std::popcount(board.Knights(isWhite))
+			+ BishopValue * std::popcount(board.Bishops(isWhite))
+			+ RookValue * std::popcount(board.Rooks(isWhite))
+			+ QueenValue * std::popcount(board.Queens(isWhite));
+	}
+
+	// Mate and tablebase scores are stored relative to the node rather than the root, so they stay correct
+	// when the entry is reached through a different path length
+	static int ScoreToTT(int score, int ply)
+	{
+		if (score >= TablebaseWinThreshold) return score + ply;
+		if (score <= -TablebaseWinThreshold) return score - ply;
+		return score;
+	}
+
+	static int ScoreFromTT(int score, int ply)
+	{
+		if (score >= TablebaseWinThreshold) return score - ply;
+		if (score <= -TablebaseWinThreshold) return score + ply;
+		return score;
+	}
+
+	template<SearchEvaluator TEvaluator>
+	void Minimax<TEvaluator>::SetGameHistory(std::span<const uint64_t> positionKeys)
+	{
+		if (positionKeys.size() > MaxReversiblePlies)
+			positionKeys = positionKeys.last(MaxReversiblePlies);
+
+		m_KeyStack.assign(positionKeys.begin(), positionKeys.end());
+		m_RootIndex = positionKeys.size();
+	}
+
+	template<SearchEvaluator TEvaluator>
+	Move Minimax<TEvaluator>::FindBestMove(const Board& board, int maxDepth, TEvaluator& evaluator)
+	{
+		SearchLimits limits;
+		limits.Depth = maxDepth;
+		return FindBestMove(board, limits, evaluator);
+	}
+
+	template<SearchEvaluator TEvaluator>
+	Move Minimax<TEvaluator>::FindBestMove(const Board& board, const SearchLimits& limits, TEvaluator& evaluator, const SearchInfoCallback& onInfo)
+	{
+		SearchClock::time_point startTime = SearchClock::now();
+
+		m_MaxDepth = std::clamp(limits.Depth, 1, MaxPly - 1);
+		m_Evaluator = &evaluator;
 		m_BestMove = Move(Tile::None, Tile::None);
+		m_BestValue = 0;
+		m_PrincipalVariations.clear();
+		m_Lines.clear();
+		m_Stats = {};
+		uint64_t pawnTableProbes = m_State.PawnTable.GetProbes();
+		uint64_t pawnTableHits = m_State.PawnTable.GetHits();
+		m_NodeLimit = limits.Nodes ? limits.Nodes : std::numeric_limits<uint64_t>::max();
+		m_IsStopped = false;
+		m_KeyStack.resize(m_RootIndex + MaxPly);
+
+		m_State.KillerMoves.Clear();
+		m_State.HistoryHeuristics.Age();
+
+		m_RootMoves = MoveGeneratorSimple::GenerateLegalMoves(board);
+		if (!limits.SearchMoves.empty())
+		{
+			std::vector<Move> allMoves = m_RootMoves;
+			std::erase_if(m_RootMoves, [&limits](const Move& move)
+			{
+				return std::none_of(limits.SearchMoves.begin(), limits.SearchMoves.end(),
+					[&move](const Move& other) { return other == move && other.Promotion == move.Promotion; });
+			});
+
+			// None of them legal, so there is nothing to restrict the search to
+			if (m_RootMoves.empty())
+				m_RootMoves = std::move(allMoves);
+		}
 
-		constexpr int alpha = std::numeric_limits<int>::min();
-		constexpr int beta = std::numeric_limits<int>::max();
+		if (m_RootMoves.empty())
+		{
+			m_BestValue = board.IsCheck() ? -MateScore : DrawScore;
+			return m_BestMove;
+		}
+
+		// In a tablebase position only the moves keeping the best result are searched, leaving the search
+		// to pick between them
+		if (m_Tablebase && std::popcount(board.Occupied()) <= std::min(m_Options.SyzygyProbeLimit, m_Tablebase->GetMaxPieces()))
+			m_Tablebase->FilterRootMoves(board, m_RootMoves);
+
+		// No lines to search when there are fewer root moves than requested
+		int multiPV = std::clamp(m_Options.MultiPV, 1, (int)m_RootMoves.size());
+
+		// Iterative deepening: each iteration seeds the transposition table, killers and history
+		// that order the moves of the next one
+		for (int depth = 1; depth <= m_MaxDepth && !m_IsStopped; depth++)
+		{
+			m_State.Depth = depth;
+			uint64_t iterationStartNodes = m_Stats.Nodes;
 
-		Run(board, maxDepth, alpha, beta, board.IsWhiteTurn());
+			std::vector<PrincipalVariation> lines;
+			m_ExcludedRootMoves.clear();
+
+			for (m_PVIndex = 0; m_PVIndex < multiPV; m_PVIndex++)
+			{
+				const PrincipalVariation* previous = m_PVIndex < (int)m_Lines.size() ? &m_Lines[m_PVIndex] : nullptr;
+				int value = SearchRoot(board, depth, previous);
+				if (m_IsStopped)
+					break;
+
+				std::span<const Move> line = m_State.PVTable.GetLine();
+				lines.push_back({ depth, value, std::vector<Move>(line.begin(), line.end()) });
+				m_ExcludedRootMoves.push_back(line.front());
+			}
+
+			if (m_IsStopped)
+				break;
+
+			// A later line can come out better than an earlier one when the search is unstable
+			std::stable_sort(lines.begin(), lines.end(),
+				[](const PrincipalVariation& a, const PrincipalVariation& b) { return a.Score > b.Score; });
+
+			m_Lines = std::move(lines);
+			m_BestMove = m_Lines.front().Moves.front();
+			m_BestValue = m_Lines.front().Score;
+			m_PrincipalVariations.push_back(m_Lines.front());
+			VL_STATS(m_Stats.IterationNodes[depth] = m_Stats.Nodes - iterationStartNodes);
+
+			if (onInfo)
+			{
+				SearchInfo info;
+				info.Depth = depth;
+				info.Nodes = m_Stats.Nodes;
+				info.Time = std::chrono::duration_cast<std::chrono::milliseconds>(SearchClock::now() - startTime);
+				info.NodesPerSecond = m_Stats.Nodes * 1000 / std::max<int64_t>(info.Time.count(), 1);
+
+				for (size_t i = 0; i < m_Lines.size(); i++)
+				{
+					info.MultiPV = (int)i + 1;
+					info.Score = m_Lines[i].Score;
+					info.PrincipalVariation = m_Lines[i].Moves;
+					onInfo(info);
+				}
+			}
+
+			// Mate score is MateScore minus the distance in plies
+			if (limits.Mate > 0 && m_BestValue >= MateThreshold && (MateScore - m_BestValue + 1) / 2 <= limits.Mate)
+				break;
+		}
+
+		m_Stats.Time = std::chrono::duration_cast<std::chrono::milliseconds>(SearchClock::now() - startTime);
+		VL_STATS(m_Stats.PawnTableProbes = m_State.PawnTable.GetProbes() - pawnTableProbes);
+		VL_STATS(m_Stats.PawnTableHits = m_State.PawnTable.GetHits() - pawnTableHits);
+
+		// Stopped before the first iteration found anything
+		if (!m_BestMove.IsValid())
+			m_BestMove = m_RootMoves.front();
 
 		return m_BestMove;
 	}
 
-	int Minimax::Run(Board& board, int depth, int alpha, int beta, bool isMaximizing)
+	template<SearchEvaluator TEvaluator>
+	int Minimax<TEvaluator>::SearchRoot(const Board& board, int depth, const PrincipalVariation* previous)
+	{
+		// Aspiration window around the previous iteration's score, widened on each fail
+		int delta = AspirationWindow;
+		int alpha = -Infinity;
+		int beta = Infinity;
+		if (depth >= AspirationMinDepth && previous)
+		{
+			alpha = std::max(previous->Score - delta, -Infinity);
+			beta = std::min(previous->Score + delta, Infinity);
+		}
+
+		m_FollowedLine = previous ? &previous->Moves : nullptr;
+
+		while (true)
+		{
+			m_IsFollowingPV = m_FollowedLine != nullptr;
+			int value = Run(board, depth, 0, alpha, beta);
+			if (m_IsStopped)
+				return 0;
+
+			if (value <= alpha)
+			{
+				beta = (alpha + beta) / 2;
+				alpha = std::max(value - delta, -Infinity);
+			}
+			else if (value >= beta)
+			{
+				beta = std::min(value + delta, Infinity);
+			}
+			else
+			{
+				return value;
+			}
+
+			delta *= 2;
+		}
+	}
+
+	template<SearchEvaluator TEvaluator>
+	bool Minimax<TEvaluator>::IsExcludedRootMove(const Move& move) const
+	{
+		auto isSame = [&move](const Move& other) { return other == move && other.Promotion == move.Promotion; };
+		return std::none_of(m_RootMoves.begin(), m_RootMoves.end(), isSame)
+			|| std::any_of(m_ExcludedRootMoves.begin(), m_ExcludedRootMoves.end(), isSame);
+	}
+
+	template<SearchEvaluator TEvaluator>
+	std::optional<int> Minimax<TEvaluator>::ProbeTablebase(const Board& board, int ply) const
+	{
+		// WDL tables ignore the fifty-move counter, so they are only exact right after it was reset
+		if (!m_Tablebase || board.GetHalfmoveCounter() != 0
+			|| std::popcount(board.Occupied()) > std::min(m_Options.SyzygyProbeLimit, m_Tablebase->GetMaxPieces()))
+			return std::nullopt;
+
+		std::optional<WDLScore> wdl = m_Tablebase->ProbeWDL(board);
+		if (!wdl)
+			return std::nullopt;
+
+		// Results spoiled by the fifty-move rule stay just off a draw, so the search still prefers the better side of it
+		switch (*wdl)
+		{
+		case WDLScore::Win: return TablebaseWinScore - ply;
+		case WDLScore::CursedWin: return DrawScore + 1;
+		case WDLScore::Draw: return DrawScore;
+		case WDLScore::BlessedLoss: return DrawScore - 1;
+		case WDLScore::Loss: return -TablebaseWinScore + ply;
+		}
+		return std::nullopt;
+	}
+
+	template<SearchEvaluator TEvaluator>
+	bool Minimax<TEvaluator>::IsRepetition(const Board& board, int ply) const
+	{
+		// Only positions since the last capture or pawn move can repeat, and only with the same side to move.
+		// The position two plies back can't be the same, as both sides have moved since.
+		size_t index = m_RootIndex + ply;
+		size_t distance = std::min<size_t>(board.GetHalfmoveCounter(), index);
+
+		for (size_t i = 4; i <= distance; i += 2)
+			if (m_KeyStack[index - i] == board.GetHash())
+				return true;
+
+		return false;
+	}
+
+	template<SearchEvaluator TEvaluator>
+	int Minimax<TEvaluator>::Run(const Board& board, int depth, int ply, int alpha, int beta, bool isNullMoveAllowed)
 	{
-		if (depth == 0)
+		if (depth <= 0)
+			return Quiescence(board, ply, alpha, beta);
+
+		if (CheckStop())
+			return 0;
+
+		m_State.PVTable.Clear(ply);
+		VL_STATS(m_Stats.SelectiveDepth = std::max(m_Stats.SelectiveDepth, ply));
+
+		uint64_t hash = board.GetHash();
+		m_KeyStack[m_RootIndex + ply] = hash;
+
+		// A repetition is scored as a draw straight away; the side that can avoid it will
+		if (ply > 0 && IsRepetition(board, ply))
+			return DrawScore;
+
+		// Mate on the move that reaches the fifty-move limit still counts, so the move generator only runs when in check
+		if (ply > 0 && board.IsFiftyMoveRule())
+			return board.IsCheck() && board.IsCheckmate() ? -MateScore + ply : DrawScore;
+
+		if (ply >= MaxPly - 1)
 			return Evaluate(board);
 
-		int bestValue = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+		bool isPvNode = beta - alpha > 1;
 
-		std::vector<Move> moves = MoveGeneratorSimple::GenerateLegalMoves(board);
+		TranspositionTable& tt = m_State.TranspositionTable;
 
-		if (moves.empty())
+		// Tablebase hit: wins and losses only bound the score, since a faster mate may still be found below
+		if (ply > 0)
 		{
-			if (board.IsCheck(true))
-				return isMaximizing ? std::numeric_limits<int>::min() + (m_MaxDepth - depth)
-				: std::numeric_limits<int>::max() - (m_MaxDepth - depth);
-			else
-				return 0; // Stalemate (Draw)
+			if (std::optional<int> tablebaseScore = ProbeTablebase(board, ply))
+			{
+				VL_STATS(m_Stats.TablebaseHits++);
+
+				int score = *tablebaseScore;
+				TTEntryFlag flag = score >= TablebaseWinThreshold ? TTEntryFlag::LowerBound
+					: score <= -TablebaseWinThreshold ? TTEntryFlag::UpperBound
+					: TTEntryFlag::Exact;
+
+				if (flag == TTEntryFlag::Exact
+					|| (flag == TTEntryFlag::LowerBound && score >= beta)
+					|| (flag == TTEntryFlag::UpperBound && score <= alpha))
+				{
+					tt.Store(hash, ScoreToTT(score, ply), Move(), std::min(depth + TablebaseDepthBonus, MaxPly - 1), flag);
+					return score;
+				}
+			}
 		}
 
-		for (const Move& move : moves)
+		Move hashMove;
+		VL_STATS(m_Stats.TTProbes++);
+		if (TTEntry* entry = tt.Lookup(hash))
 		{
-			Board tempBoard = board;
-			tempBoard.MakeMove(move);
+			VL_STATS(m_Stats.TTHits++);
+			hashMove = entry->BestMove;
 
-			int value = Run(tempBoard, depth - 1, alpha, beta, !isMaximizing);
-			
-			if (isMaximizing)
+			// PV nodes always search, so the line they return isn't cut short
+			if (!isPvNode && entry->Depth >= depth)
 			{
-				if (value > bestValue)
+				int score = ScoreFromTT(entry->Score, ply);
+				if (entry->Flag == TTEntryFlag::Exact
+					|| (entry->Flag == TTEntryFlag::LowerBound && score >= beta)
+					|| (entry->Flag == TTEntryFlag::UpperBound && score <= alpha))
 				{
-					bestValue = value;
-					alpha = std::max(alpha, bestValue);
-					if (depth == m_MaxDepth)
+					VL_STATS(m_Stats.TTCutoffs++);
+					return score;
+				}
+			}
+		}
+
+		bool inCheck = board.IsCheck();
+		int staticEval = inCheck ? -Infinity : Evaluate(board);
+
+		if (!isPvNode && !inCheck && std::abs(beta) < MateThreshold)
+		{
+			// Reverse futility pruning: far enough above beta that a shallow search won't bring it back down
+			if (m_Options.ReverseFutilityPruning && depth <= ReverseFutilityDepth
+				&& staticEval - ReverseFutilityMargin * depth >= beta)
+				return staticEval;
+
+			// Null move pruning: if passing still fails high, a real move almost certainly does too
+			int nonPawnMaterial = NonPawnMaterial(board, board.IsWhiteTurn());
+			if (m_Options.NullMovePruning && isNullMoveAllowed && depth >= NullMoveMinDepth
+				&& staticEval >= beta && nonPawnMaterial > 0)
+			{
+				int reduction = 3 + depth / 6;
+
+				VL_STATS(m_Stats.NullMoveSearches++);
+				Board nullBoard = board;
+				nullBoard.MakeNullMove();
+
+				int value;
+				{
+					EvaluatorMoveScope<TEvaluator> evaluatorScope(*m_Evaluator, board, nullBoard);
+					value = -Run(nullBoard, depth - 1 - reduction, ply + 1, -beta, -beta + 1, false);
+				}
+				if (m_IsStopped)
+					return 0;
+
+				if (value >= beta)
+				{
+					// Don't trust mate scores found without a real move
+					if (value >= MateThreshold)
+						value = beta;
+
+					// Zugzwang is common in low material endgames, so confirm the cutoff with a reduced search
+					bool isConfirmed = nonPawnMaterial > NullMoveVerificationMaterial;
+					if (!isConfirmed)
+					{
+						int verified = Run(board, depth - 1 - reduction, ply, beta - 1, beta, false);
+						if (m_IsStopped)
+							return 0;
+						isConfirmed = verified >= beta;
+					}
+
+					if (isConfirmed)
 					{
-						m_BestMove = move;
-						m_BestValue = bestValue;
+						VL_STATS(m_Stats.NullMoveCutoffs++);
+						return value;
 					}
 				}
 			}
+		}
+
+		Move pvMove;
+		if (m_IsFollowingPV)
+		{
+			const std::vector<Move>& previousLine = *m_FollowedLine;
+			if (ply < (int)previousLine.size())
+				pvMove = previousLine[ply];
 			else
+				m_IsFollowingPV = false;
+		}
+
+		std::vector<Move> moves = MoveGeneratorSimple::GeneratePseudoLegalMoves(board);
+		MoveOrdering::ScoreMoves(moves, board, pvMove, hashMove, m_State, ply);
+
+		bool canPruneQuiets = ply > 0 && !inCheck && std::abs(alpha) < MateThreshold;
+
+		int originalAlpha = alpha;
+		int bestValue = -Infinity;
+		Move bestMove;
+		int legalMoves = 0;
+		int quietsSearched = 0;
+
+		for (size_t i = 0; i < moves.size(); i++)
+		{
+			const Move& move = MoveOrdering::PickNextMove(moves, i);
+
+			// Moves of earlier MultiPV lines, or losing the tablebase result
+			if (ply == 0 && IsExcludedRootMove(move))
+				continue;
+
+			Board tempBoard = board;
+			tempBoard.MakeMove(move);
+			if (tempBoard.IsCheck(false))
+				continue;
+
+			legalMoves++;
+			bool isQuiet = move.IsQuiet();
+
+			// Only the first move searched here can continue the previous PV
+			if (m_IsFollowingPV && !(move == pvMove && move.Promotion == pvMove.Promotion))
+				m_IsFollowingPV = false;
+			bool givesCheck = tempBoard.IsCheck();
+
+			// Pruning only kicks in once a move has been searched, so the node always has a real score
+			if (canPruneQuiets && isQuiet && !givesCheck && bestValue > -MateThreshold)
 			{
-				if (value < bestValue)
+				// Late move pruning: with good ordering, late quiet moves at low depth rarely matter
+				if (m_Options.LateMovePruning && depth <= LateMovePruningDepth
+					&& quietsSearched >= 3 + depth * depth)
+					continue;
+
+				// Futility pruning: a quiet move can't make up the gap to alpha this close to the leaves
+				if (m_Options.FutilityPruning && depth <= FutilityDepth
+					&& staticEval + FutilityMargin * depth <= alpha)
+					continue;
+			}
+
+			EvaluatorMoveScope<TEvaluator> evaluatorScope(*m_Evaluator, board, tempBoard);
+
+			// Principal variation search: the first move gets the full window, the rest are expected to
+			// fail low and only need a null window scout, re-searched if they turn out to beat alpha
+			int value;
+			if (legalMoves == 1)
+			{
+				value = -Run(tempBoard, depth - 1, ply + 1, -beta, -alpha);
+			}
+			else
+			{
+				int reduction = 0;
+				if (m_Options.LateMoveReductions && depth >= LateMoveReductionDepth && legalMoves > LateMoveReductionMinMoves
+					&& isQuiet && !inCheck && !givesCheck)
 				{
-					bestValue = value;
-					beta = std::min(beta, bestValue);
-					if (depth == m_MaxDepth)
-					{
-						m_BestMove = move;
-						m_BestValue = bestValue;
-					}
+					reduction = s_Reductions[depth][std::min(legalMoves, 63)];
+					reduction = std::clamp(reduction, 0, depth - 2);
+				}
+
+				VL_STATS(m_Stats.ReducedSearches += reduction > 0);
+				value = -Run(tempBoard, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+
+				// Reduced move beat alpha, verify at full depth
+				if (value > alpha && reduction > 0)
+				{
+					VL_STATS(m_Stats.ReducedReSearches++);
+					value = -Run(tempBoard, depth - 1, ply + 1, -alpha - 1, -alpha);
 				}
+
+				// Scout failed high inside a PV node, get the exact score
+				if (value > alpha && value < beta)
+					value = -Run(tempBoard, depth - 1, ply + 1, -beta, -alpha);
+			}
+
+			// Scores from an interrupted subtree are meaningless
+			if (m_IsStopped)
+				return 0;
+
+			if (isQuiet)
+				quietsSearched++;
+
+			if (value > bestValue)
+			{
+				bestValue = value;
+				bestMove = move;
+
+				// A root move that fails low against the aspiration window doesn't replace the last best move
+				if (ply == 0 && m_PVIndex == 0 && (value > alpha || !m_BestMove.IsValid()))
+					m_BestMove = move;
+			}
+
+			if (value > alpha)
+			{
+				alpha = value;
+				m_State.PVTable.Update(ply, move);
 			}
 
-			if (beta <= alpha)
+			if (alpha >= beta)
+			{
+				VL_STATS(m_Stats.BetaCutoffs++);
+				VL_STATS(m_Stats.CutoffsByMoveIndex[std::min(legalMoves, SearchStats::MoveIndexBuckets) - 1]++);
+
+				if (isQuiet)
+				{
+					m_State.KillerMoves.StoreKillerMove(move, ply);
+					m_State.HistoryHeuristics.UpdateHistory(move, depth);
+				}
 				break;
+			}
+		}
+
+		if (legalMoves == 0)
+			return inCheck ? -MateScore + ply : DrawScore; // Checkmate or stalemate
+
+		// Later MultiPV lines are searched without the earlier lines' moves, so their result isn't the root's
+		if (ply > 0 || m_PVIndex == 0)
+		{
+			TTEntryFlag flag = bestValue >= beta ? TTEntryFlag::LowerBound
+				: bestValue > originalAlpha ? TTEntryFlag::Exact
+				: TTEntryFlag::UpperBound;
+			tt.Store(hash, ScoreToTT(bestValue, ply), bestMove, depth, flag);
 		}
 
 		return bestValue;
 	}
 
+	template<SearchEvaluator TEvaluator>
+	int Minimax<TEvaluator>::Quiescence(const Board& board, int ply, int alpha, int beta)
+	{
+		if (CheckStop())
+			return 0;
+
+		m_State.PVTable.Clear(ply);
+		VL_STATS(m_Stats.QuiescenceNodes++);
+		VL_STATS(m_Stats.SelectiveDepth = std::max(m_Stats.SelectiveDepth, ply));
+
+		// Only compared against the window, so a lazy bound decides the same as the exact score
+		int standPat = EvaluateLazy(board, alpha, beta);
+		if (standPat >= beta || ply >= MaxPly - 1)
+			return standPat;
+
+		if (standPat > alpha)
+			alpha = standPat;
+
+		std::vector<Move> moves = MoveGeneratorSimple::GeneratePseudoLegalMoves(board);
+		std::erase_if(moves, [](const Move& move) { return !move.IsCapture() && move.Promotion != PieceType::Queen; });
+		MoveOrdering::ScoreCaptures(moves, board);
+
+		for (size_t i = 0; i < moves.size(); i++)
+		{
+			const Move& move = MoveOrdering::PickNextMove(moves, i);
+
+			// Losing exchanges can't raise the stand pat score
+			if (MoveOrdering::SEE(board, move) < 0)
+				continue;
+
+			Board tempBoard = board;
+			tempBoard.MakeMove(move);
+			if (tempBoard.IsCheck(false))
+				continue;
+
+			EvaluatorMoveScope<TEvaluator> evaluatorScope(*m_Evaluator, board, tempBoard);
+			int value = -Quiescence(tempBoard, ply + 1, -beta, -alpha);
+			if (m_IsStopped)
+				return 0;
+			if (value >= beta)
+				return value;
+			if (value > alpha)
+				alpha = value;
+		}
+
+		return alpha;
+	}
+
+	template class Minimax<Evaluator>;
+	template class Minimax<PieceValueEvaluator>;
+	template class Minimax<PositionalEvaluator>;
+	template class Minimax<NNUEEvaluator>;
+
 }
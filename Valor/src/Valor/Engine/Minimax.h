@@ -3,26 +3,151 @@
 #include "Valor/Chess/Board.h"
 
 #include "Valor/Engine/Evaluator/Evaluator.h"
+#include "Valor/Engine/SearchControl.h"
+#include "Valor/Engine/SearchLimits.h"
+#include "Valor/Engine/SearchOptions.h"
+#include "Valor/Engine/SearchState.h"
+#include "Valor/Engine/SearchStats.h"
+#include "Valor/Engine/Tablebase/SyzygyTablebase.h"
+
+#include <optional>
+#include <span>
 
 namespace Valor::Engine {
 
+	// Iterative deepening principal variation search with aspiration windows and a quiescence search at the leaves.
+	// Null move pruning, late move reductions and futility/late move pruning are controlled by `SearchOptions`.
+	// In MultiPV mode each iteration searches the root once per line, excluding the moves of the lines before it.
+	// Instantiated in Minimax.cpp for each of the engine's evaluators, and for `Evaluator` to search with any other.
+	template<SearchEvaluator TEvaluator>
 	class Minimax
 	{
 	public:
-		Minimax()
-			: m_MaxDepth(1), m_Evaluator(nullptr) {}
+		// `control`, if given, is polled every few thousand nodes. A stopped search returns the best move
+		// of the last completed iteration.
+		explicit Minimax(SearchState& state, const SearchOptions& options = {}, const SearchControl* control = nullptr)
+			: m_State(state), m_Options(options), m_Control(control), m_MaxDepth(1), m_Evaluator(nullptr) {}
+
+		// Zobrist keys of the positions played before the searched one, oldest first. Repeating one of them,
+		// or a position earlier in the search path, is scored as a draw.
+		void SetGameHistory(std::span<const uint64_t> positionKeys);
+
+		// Endgame tablebases to probe, or null. Must outlive the search.
+		void SetTablebase(const SyzygyTablebase* tablebase) { m_Tablebase = tablebase; }
+
+		Move FindBestMove(const Board& board, int maxDepth, TEvaluator& evaluator);
+		Move FindBestMove(const Board& board, const SearchLimits& limits, TEvaluator& evaluator, const SearchInfoCallback& onInfo = {});
+
+		int GetBestValue() const { return m_BestValue; }
+		uint64_t GetNodes() const { return m_Stats.Nodes; }
+		const SearchStats& GetStats() const { return m_Stats; }
+		bool IsStopped() const { return m_IsStopped; }
 
-		Move FindBestMove(Board& board, int maxDepth, Evaluator* evaluator);
+		// One entry per completed iteration, in increasing depth
+		const std::vector<PrincipalVariation>& GetPrincipalVariations() const { return m_PrincipalVariations; }
+
+		// Lines of the last completed iteration, best first. Holds up to `SearchOptions::MultiPV` lines.
+		const std::vector<PrincipalVariation>& GetLines() const { return m_Lines; }
+	public:
+		constexpr static int Infinity = MateScore + 1;
 	private:
+		SearchState& m_State;
+		SearchOptions m_Options;
+		const SearchControl* m_Control;
 		int m_MaxDepth;
-		Evaluator* m_Evaluator;
+		TEvaluator* m_Evaluator;
 
 		Move m_BestMove = Move(Tile::None, Tile::None);
 		int m_BestValue = 0;
 
-		int Run(Board& board, int depth, int alpha, int beta, bool isMaximizing);
+		std::vector<PrincipalVariation> m_PrincipalVariations;
+		std::vector<PrincipalVariation> m_Lines;
+		const std::vector<Move>* m_FollowedLine = nullptr; // Line of the previous iteration being searched again
+		bool m_IsFollowingPV = false; // Still on the followed line, whose moves are searched first
+
+		// Index of the line being searched, and root moves of the lines already found this iteration
+		int m_PVIndex = 0;
+		std::vector<Move> m_ExcludedRootMoves;
+
+		// Keys of the game history followed by one per ply of the current search path
+		std::vector<uint64_t> m_KeyStack;
+		size_t m_RootIndex = 0;
+
+		// Legal root moves, narrowed to the ones keeping the tablebase result when the root is in a table
+		std::vector<Move> m_RootMoves;
+		const SyzygyTablebase* m_Tablebase = nullptr;
+
+		SearchStats m_Stats;
+		uint64_t m_NodeLimit = 0;
+		bool m_IsStopped = false;
+
+		// Counts a node, and every few thousand nodes checks whether the search has been stopped
+		bool CheckStop()
+		{
+			if (++m_Stats.Nodes >= m_NodeLimit)
+				m_IsStopped = true;
+			else if ((m_Stats.Nodes & 2047) == 0 && m_Control && m_Control->ShouldStop())
+				m_IsStopped = true;
+			return m_IsStopped;
+		}
+
+		bool IsRepetition(const Board& board, int ply) const;
+		// Root moves taken by earlier MultiPV lines or filtered out by the tablebase
+		bool IsExcludedRootMove(const Move& move) const;
+
+		// Tablebase score for a node, empty if it isn't in a loaded table
+		std::optional<int> ProbeTablebase(const Board& board, int ply) const;
+
+		// Searches the root with an aspiration window around `previous`'s score, widening it until the score fits
+		int SearchRoot(const Board& board, int depth, const PrincipalVariation* previous);
+
+		int Run(const Board& board, int depth, int ply, int alpha, int beta, bool isNullMoveAllowed = true);
+		int Quiescence(const Board& board, int ply, int alpha, int beta);
+
+		// Static evaluation from the side to move's point of view, through the evaluation cache
+		int Evaluate(const Board& board)
+		{
+			int score;
+			VL_STATS(m_Stats.EvalCacheProbes++);
+			if (m_State.EvalCache.Probe(board.GetHash(), score))
+			{
+				VL_STATS(m_Stats.EvalCacheHits++);
+			}
+			else
+			{
+				VL_STATS(m_Stats.Evaluations++);
+				score = m_Evaluator->Evaluate(board);
+				m_State.EvalCache.Store(board.GetHash(), score);
+			}
+			return board.IsWhiteTurn() ? score : -score;
+		}
+
+		// Same, but the evaluator may stop early once the score is outside (alpha, beta). The result is then
+		// only a bound, and isn't cached.
+		int EvaluateLazy(const Board& board, int alpha, int beta)
+		{
+			int score;
+			bool isWhite = board.IsWhiteTurn();
+			VL_STATS(m_Stats.EvalCacheProbes++);
+			if (m_State.EvalCache.Probe(board.GetHash(), score))
+			{
+				VL_STATS(m_Stats.EvalCacheHits++);
+				return isWhite ? score : -score;
+			}
 
-		int Evaluate(const Board& board) const { return m_Evaluator->Evaluate(board); }
+			bool isExact;
+			VL_STATS(m_Stats.Evaluations++);
+			score = m_Evaluator->EvaluateLazy(board, isWhite ? alpha : -beta, isWhite ? beta : -alpha, isExact);
+			if (isExact)
+			{
+				m_State.EvalCache.Store(board.GetHash(), score);
+			}
+			else
+			{
+				VL_STATS(m_Stats.LazyEvaluations++);
+			}
+			return isWhite ? score : -score;
+		}
 	};
 
 }
@@ -0,0 +1,154 @@
+#include "vlpch.h"
+#include "Valor/Engine/MoveOrdering.h"
+
+#include "Valor/Chess/MoveGeneration/MagicBitboard.h"
+#include "Valor/Engine/Evaluator/Evaluator.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Valor::Engine::MoveOrdering {
+
+	// Indexed by `PieceType`; the king is worth more than any exchange can win back
+	constexpr int SEEValues[6] = { PawnValue, KnightValue, BishopValue, RookValue, QueenValue, 20000 };
+
+	static PieceType GetVictim(const Board& board, Move move)
+	{
+		if (move.IsEnPassant())
+			return PieceType::Pawn;
+		return board.GetPiece(move.Target).Type;
+	}
+
+	static PieceType GetAttacker(const Board& board, Move move)
+	{
+		return move.Piece != PieceType::None ? move.Piece : board.GetPiece(move.Source).Type;
+	}
+
+	// Most valuable victim, least valuable attacker
+	static int MVVLVA(PieceType victim, PieceType attacker)
+	{
+		int victimValue = victim == PieceType::None ? 0 : SEEValues[(int)victim];
+		return victimValue * 8 - (int)attacker;
+	}
+
+	int SEE(const Board& board, Move move)
+	{
+		PieceType victim = GetVictim(board, move);
+		PieceType attacker = GetAttacker(board, move);
+
+		int gain[32];
+		int depth = 0;
+
+		uint64_t occupancy = board.Occupied();
+		uint64_t fromSet = 1ULL << move.Source;
+		uint64_t attackers = board.AttackersTo(move.Target, occupancy);
+		uint64_t diagonalSliders = board.Bishops() | board.Queens();
+		uint64_t straightSliders = board.Rooks() | board.Queens();
+		bool isWhite = board.IsWhiteTurn();
+
+		if (move.IsEnPassant())
+			occupancy ^= 1ULL << Tile(move.Source.GetRank(), move.Target.GetFile());
+
+		gain[0] = victim == PieceType::None ? 0 : SEEValues[(int)victim];
+		do
+		{
+			depth++;
+			isWhite = !isWhite;
+
+			// Speculative score if the piece on the target square is taken back
+			gain[depth] = SEEValues[(int)attacker] - gain[depth - 1];
+			if (std::max(-gain[depth - 1], gain[depth]) < 0)
+				break;
+
+			attackers ^= fromSet;
+			occupancy ^= fromSet;
+
+			// Sliders behind the piece that just moved join the exchange
+			attackers |= (MagicBitboard::GetBishopAttacks(move.Target, occupancy) & diagonalSliders)
+				| (MagicBitboard::GetRookAttacks(move.Target, occupancy) & straightSliders);
+			attackers &= occupancy;
+
+			// Next least valuable attacker for the side to recapture
+			fromSet = 0;
+			uint64_t sideAttackers = attackers & board.AllPieces(isWhite);
+			for (int type = 0; type < 6 && sideAttackers; type++)
+			{
+				uint64_t candidates = sideAttackers & board.GetPieceBitboard(static_cast<PieceType>(type));
+				if (candidates)
+				{
+					fromSet = candidates & (0 - candidates);
+					attacker = static_cast<PieceType>(type);
+					break;
+				}
+			}
+		} while (fromSet && depth < 31);
+
+		while (--depth)
+			gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+		return gain[0];
+	}
+
+	void ScoreMoves(std::vector<Move>& moves, const Board& board, Move pvMove, Move hashMove, const SearchState& state, int ply)
+	{
+		for (Move& move : moves)
+		{
+			if (move == pvMove && move.Promotion == pvMove.Promotion)
+			{
+				move.Priority = PVMoveScore;
+			}
+			else if (move == hashMove && move.Promotion == hashMove.Promotion)
+			{
+				move.Priority = HashMoveScore;
+			}
+			else if (move.IsCapture() || move.Promotion == PieceType::Queen)
+			{
+				int mvvlva = MVVLVA(GetVictim(board, move), GetAttacker(board, move));
+				if (move.Promotion == PieceType::Queen)
+					mvvlva += QueenValue * 8;
+
+				move.Priority = (SEE(board, move) >= 0 ? GoodCaptureScore : BadCaptureScore) + mvvlva;
+			}
+			else if (int slot = state.KillerMoves.GetKillerSlot(move, ply); slot != -1)
+			{
+				move.Priority = slot == 0 ? PrimaryKillerScore : SecondaryKillerScore;
+			}
+			else if (move.IsPromotion())
+			{
+				// Underpromotions are almost never worth looking at early
+				move.Priority = BadCaptureScore - 1;
+			}
+			else
+			{
+				move.Priority = state.HistoryHeuristics.GetHistoryScore(move);
+			}
+		}
+	}
+
+	void ScoreCaptures(std::vector<Move>& moves, const Board& board)
+	{
+		for (Move& move : moves)
+		{
+			int mvvlva = MVVLVA(GetVictim(board, move), GetAttacker(board, move));
+			if (move.Promotion == PieceType::Queen)
+				mvvlva += QueenValue * 8;
+			move.Priority = mvvlva;
+		}
+	}
+
+	const Move& PickNextMove(std::vector<Move>& moves, size_t index)
+	{
+		size_t best = index;
+		for (size_t i = index + 1; i < moves.size(); i++)
+		{
+			if (moves[i].Priority > moves[best].Priority)
+				best = i;
+		}
+
+		if (best != index)
+			std::swap(moves[index], moves[best]);
+
+		return moves[index];
+	}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Engine/SearchState.h"
+
+#include <vector>
+
+namespace Valor::Engine::MoveOrdering {
+
+	// Priority bands, highest first. Quiet moves are ordered by their history score,
+	// which `HistoryHeuristics` keeps below `KillerScore`.
+	constexpr int PVMoveScore = 5'000'000;
+	constexpr int HashMoveScore = 4'000'000;
+	constexpr int GoodCaptureScore = 3'000'000;
+	constexpr int PrimaryKillerScore = 2'000'001;
+	constexpr int SecondaryKillerScore = 2'000'000;
+	constexpr int BadCaptureScore = -1'000'000;
+
+	// Static exchange evaluation of the capture sequence started by `move` on its target square
+	int SEE(const Board& board, Move move);
+
+	// Assigns `Move::Priority` for every move. `pvMove` is the previous iteration's PV move while the search
+	// is still following that line, and is invalid otherwise.
+	void ScoreMoves(std::vector<Move>& moves, const Board& board, Move pvMove, Move hashMove, const SearchState& state, int ply);
+	void ScoreCaptures(std::vector<Move>& moves, const Board& board);
+
+	// Swaps the highest priority move among [index, end) into `index` and returns it.
+	// Picking lazily is cheaper than a full sort, since most nodes cut off after a few moves.
+	const Move& PickNextMove(std::vector<Move>& moves, size_t index);
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Valor/Chess/Move.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+
+namespace Valor::Engine {
+
+	constexpr int MaxPly = 128;
+
+	// Principal variation of one completed iterative deepening iteration
+	struct PrincipalVariation
+	{
+		int Depth = 0;
+		int Score = 0;
+		std::vector<Move> Moves;
+	};
+
+	// Triangular PV table: row `ply` holds the best line found from that ply, in columns [ply, length).
+	// A node's line is its best move followed by its child's row, so no allocation happens while searching.
+	class PVTable
+	{
+	public:
+		void Clear(int ply) { m_Length[ply] = ply; }
+
+		void Update(int ply, Move move)
+		{
+			m_Table[ply][ply] = move;
+
+			int childLength = ply + 1 < MaxPly ? m_Length[ply + 1] : ply + 1;
+			for (int i = ply + 1; i < childLength; i++)
+				m_Table[ply][i] = m_Table[ply + 1][i];
+
+			m_Length[ply] = std::max(childLength, ply + 1);
+		}
+
+		std::span<const Move> GetLine(int ply = 0) const
+		{
+			return std::span<const Move>(m_Table[ply].data() + ply, m_Length[ply] - ply);
+		}
+	private:
+		std::array<std::array<Move, MaxPly>, MaxPly> m_Table;
+		std::array<int, MaxPly> m_Length = {};
+	};
+
+}
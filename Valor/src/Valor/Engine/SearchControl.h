@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <stop_token>
+
+namespace Valor::Engine {
+
+	using SearchClock = std::chrono::steady_clock;
+
+	// Lets another thread stop a running search, or move its deadline while it runs
+	class SearchControl
+	{
+	public:
+		SearchControl() = default;
+		explicit SearchControl(std::stop_token stopToken)
+			: m_StopToken(std::move(stopToken)) {}
+
+		// Only call while no search is using this control
+		void SetStopToken(std::stop_token stopToken) { m_StopToken = std::move(stopToken); }
+
+		void SetDeadline(SearchClock::time_point deadline) { m_Deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed); }
+		void ClearDeadline() { m_Deadline.store(NoDeadline, std::memory_order_relaxed); }
+
+		bool ShouldStop() const
+		{
+			return m_StopToken.stop_requested()
+				|| SearchClock::now().time_since_epoch().count() >= m_Deadline.load(std::memory_order_relaxed);
+		}
+	private:
+		constexpr static SearchClock::rep NoDeadline = std::numeric_limits<SearchClock::rep>::max();
+
+		std::stop_token m_StopToken;
+		std::atomic<SearchClock::rep> m_Deadline = NoDeadline;
+	};
+
+}
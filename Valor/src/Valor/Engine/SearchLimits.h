@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Valor/Chess/Move.h"
+#include "Valor/Engine/PrincipalVariation.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// A search stops at whichever limit is hit first. Zero means no limit.
+	struct SearchLimits
+	{
+		int Depth = MaxPly - 1;
+		uint64_t Nodes = 0;
+		std::chrono::milliseconds Time{ 0 };
+		int Mate = 0; // Stop once a mate in this many moves (or fewer) is found
+
+		// Root moves to choose from, all legal moves when empty. Moves that aren't legal are ignored.
+		std::vector<Move> SearchMoves;
+	};
+
+	// Progress report sent after every completed iteration, once per line in MultiPV mode
+	struct SearchInfo
+	{
+		int Depth = 0;
+		int MultiPV = 1; // Rank of the line, from 1
+		int Score = 0;
+		uint64_t Nodes = 0;
+		uint64_t NodesPerSecond = 0;
+		std::chrono::milliseconds Time{ 0 };
+		std::span<const Move> PrincipalVariation; // Only valid during the callback
+	};
+
+	using SearchInfoCallback = std::function<void(const SearchInfo&)>;
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace Valor::Engine {
+
+	// Switches for the selective parts of the search, mainly so each technique can be benchmarked on its own
+	struct SearchOptions
+	{
+		bool NullMovePruning = true;
+		bool LateMoveReductions = true;
+		bool ReverseFutilityPruning = true;
+		bool FutilityPruning = true;
+		bool LateMovePruning = true;
+
+		// Number of best root moves to find a line and score for, instead of only the best one
+		int MultiPV = 1;
+
+		// Largest number of pieces, kings included, for which the search probes endgame tablebases
+		int SyzygyProbeLimit = 7;
+	};
+
+}
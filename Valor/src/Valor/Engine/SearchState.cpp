@@ -0,0 +1,63 @@
+#include "vlpch.h"
+#include "Valor/Engine/SearchState.h"
+
+namespace Valor::Engine {
+
+	void KillerMoves::StoreKillerMove(Move move, int ply)
+	{
+		std::array<Move, 2>& killers = m_KillerMoves[ply];
+		if (killers[0] == move)
+			return;
+
+		killers[1] = killers[0];
+		killers[0] = move;
+	}
+
+	bool KillerMoves::IsKillerMove(Move move, int ply) const
+	{
+		return GetKillerSlot(move, ply) != -1;
+	}
+
+	int KillerMoves::GetKillerSlot(Move move, int ply) const
+	{
+		const std::array<Move, 2>& killers = m_KillerMoves[ply];
+		if (killers[0] == move) return 0;
+		if (killers[1] == move) return 1;
+		return -1;
+	}
+
+	void KillerMoves::Clear()
+	{
+		for (std::array<Move, 2>& killers : m_KillerMoves)
+			killers.fill(Move());
+	}
+
+	void HistoryHeuristics::UpdateHistory(Move move, int depth)
+	{
+		int& score = m_History[move.Source][move.Target];
+		score += depth * depth;
+
+		// Keep scores below the killer band used by move ordering
+		if (score >= MaxHistory)
+			Age();
+	}
+
+	int HistoryHeuristics::GetHistoryScore(Move move) const
+	{
+		return m_History[move.Source][move.Target];
+	}
+
+	void HistoryHeuristics::Age()
+	{
+		for (std::array<int, 64>& row : m_History)
+			for (int& score : row)
+				score /= 2;
+	}
+
+	void HistoryHeuristics::Clear()
+	{
+		for (std::array<int, 64>& row : m_History)
+			row.fill(0);
+	}
+
+}
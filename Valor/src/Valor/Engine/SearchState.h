@@ -1,23 +1,27 @@
 #pragma once
 
 #include "Valor/Chess/Move.h"
+#include "Valor/Engine/EvalCache.h"
+#include "Valor/Engine/Evaluator/PawnHashTable.h"
+#include "Valor/Engine/PrincipalVariation.h"
 #include "Valor/Engine/TranspositionTable.h"
 
 #include <array>
 
 namespace Valor::Engine {
 
-	constexpr int MaxDepth = 8;
-
 	class KillerMoves
 	{
 	public:
-		void StoreKillerMove(Move move, int depth);
-		bool IsKillerMove(Move move, int depth) const;
+		void StoreKillerMove(Move move, int ply);
+		bool IsKillerMove(Move move, int ply) const;
+
+		// 0 for the primary killer, 1 for the secondary one, -1 if `move` isn't a killer
+		int GetKillerSlot(Move move, int ply) const;
 
 		void Clear();
 	private:
-		std::array<std::array<Move, 2>, MaxDepth> m_KillerMoves;
+		std::array<std::array<Move, 2>, MaxPly> m_KillerMoves;
 	};
 
 	class HistoryHeuristics
@@ -26,17 +30,24 @@ namespace Valor::Engine {
 		void UpdateHistory(Move move, int depth);
 		int GetHistoryScore(Move move) const;
 
+		// Halves all scores so that old searches don't dominate the next one
+		void Age();
 		void Clear();
+	public:
+		constexpr static int MaxHistory = 1 << 20;
 	private:
-		std::array<std::array<int, 64>, 64> m_History;
+		std::array<std::array<int, 64>, 64> m_History = {};
 	};
 
 	struct SearchState
 	{
-		KillerMoves KillerMoves;
-		HistoryHeuristics HistoryHeuristics;
-		TranspositionTable TranspositionTable;
-		int Depth;
+		Engine::KillerMoves KillerMoves;
+		Engine::HistoryHeuristics HistoryHeuristics;
+		Engine::TranspositionTable TranspositionTable;
+		Engine::PawnHashTable PawnTable;
+		Engine::EvalCache EvalCache;
+		Engine::PVTable PVTable;
+		int Depth = 0;
 	};
 
 }
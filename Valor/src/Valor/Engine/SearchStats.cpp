@@ -0,0 +1,95 @@
+#include "vlpch.h"
+#include "Valor/Engine/SearchStats.h"
+
+#include <iomanip>
+
+namespace Valor::Engine {
+
+	SearchStats& SearchStats::operator+=(const SearchStats& other)
+	{
+		Nodes += other.Nodes;
+		QuiescenceNodes += other.QuiescenceNodes;
+		Time += other.Time;
+		SelectiveDepth = std::max(SelectiveDepth, other.SelectiveDepth);
+
+		TTProbes += other.TTProbes;
+		TTHits += other.TTHits;
+		TTCutoffs += other.TTCutoffs;
+
+		BetaCutoffs += other.BetaCutoffs;
+		for (int i = 0; i < MoveIndexBuckets; i++)
+			CutoffsByMoveIndex[i] += other.CutoffsByMoveIndex[i];
+
+		NullMoveSearches += other.NullMoveSearches;
+		NullMoveCutoffs += other.NullMoveCutoffs;
+		ReducedSearches += other.ReducedSearches;
+		ReducedReSearches += other.ReducedReSearches;
+
+		TablebaseHits += other.TablebaseHits;
+
+		PawnTableProbes += other.PawnTableProbes;
+		PawnTableHits += other.PawnTableHits;
+
+		EvalCacheProbes += other.EvalCacheProbes;
+		EvalCacheHits += other.EvalCacheHits;
+		Evaluations += other.Evaluations;
+		LazyEvaluations += other.LazyEvaluations;
+
+		for (int depth = 0; depth < MaxPly; depth++)
+			IterationNodes[depth] += other.IterationNodes[depth];
+
+		return *this;
+	}
+
+	double SearchStats::EffectiveBranchingFactor(int depth) const
+	{
+		if (depth < 2 || depth >= MaxPly || !IterationNodes[depth - 1])
+			return 0.0;
+		return (double)IterationNodes[depth] / IterationNodes[depth - 1];
+	}
+
+}
+
+namespace std {
+
+	std::ostream& operator<<(std::ostream& os, const Valor::Engine::SearchStats& stats)
+	{
+		std::ios_base::fmtflags flags = os.flags();
+		std::streamsize precision = os.precision();
+		os << std::fixed << std::setprecision(1);
+
+		os << "Nodes:          " << stats.Nodes << " (" << stats.QuiescenceNodes << " quiescence)\n";
+		os << "Time:           " << stats.Time.count() << " ms, " << stats.NodesPerSecond() << " nps\n";
+		os << "Seldepth:       " << stats.SelectiveDepth << '\n';
+
+#ifdef VL_SEARCH_STATS
+		os << "TT:             " << stats.TTProbes << " probes, " << 100.0 * stats.TTHitRate() << "% hits, "
+			<< stats.TTCutoffs << " cutoffs\n";
+
+		os << "Beta cutoffs:   " << stats.BetaCutoffs << ", " << 100.0 * stats.FirstMoveCutoffRate() << "% on the first move\n";
+		os << "  by move:     ";
+		for (int i = 0; i < Valor::Engine::SearchStats::MoveIndexBuckets; i++)
+			os << ' ' << stats.CutoffsByMoveIndex[i];
+		os << '\n';
+
+		os << "Null move:      " << stats.NullMoveSearches << " searches, " << 100.0 * stats.NullMoveSuccessRate() << "% cut off\n";
+		os << "Reductions:     " << stats.ReducedSearches << " searches, " << 100.0 * stats.ReductionSuccessRate() << "% held\n";
+		os << "Tablebase hits: " << stats.TablebaseHits << '\n';
+		os << "Pawn table:     " << stats.PawnTableProbes << " probes, " << 100.0 * stats.PawnTableHitRate() << "% hits\n";
+		os << "Eval cache:     " << stats.EvalCacheProbes << " probes, " << 100.0 * stats.EvalCacheHitRate() << "% hits\n";
+		os << "Evaluations:    " << stats.Evaluations << ", " << 100.0 * stats.LazyEvaluationRate() << "% stopped early\n";
+
+		os << "Branching:     ";
+		for (int depth = 2; depth < Valor::Engine::MaxPly && stats.IterationNodes[depth]; depth++)
+			os << ' ' << depth << ':' << stats.EffectiveBranchingFactor(depth);
+		os << '\n';
+#else
+		os << "Detailed counters are compiled out of this build\n";
+#endif
+
+		os.flags(flags);
+		os.precision(precision);
+		return os;
+	}
+
+}
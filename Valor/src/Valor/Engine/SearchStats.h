@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Valor/Engine/PrincipalVariation.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Counting costs a few increments per node, so Dist builds compile it out
+#ifndef VL_DIST
+	#define VL_SEARCH_STATS
+#endif
+
+#ifdef VL_SEARCH_STATS
+	#define VL_STATS(x) x
+#else
+	#define VL_STATS(x)
+#endif
+
+namespace Valor::Engine {
+
+	// What a search spent its nodes on. Each search thread collects its own, and they add up with `+=`.
+	// Apart from `Nodes` and `Time`, everything stays zero when VL_SEARCH_STATS is off.
+	struct SearchStats
+	{
+		constexpr static int MoveIndexBuckets = 8; // Beta cutoffs by the index of the move, the last bucket holds the rest
+
+		uint64_t Nodes = 0; // Including quiescence nodes
+		uint64_t QuiescenceNodes = 0;
+		std::chrono::milliseconds Time{ 0 };
+		int SelectiveDepth = 0; // Deepest ply reached
+
+		uint64_t TTProbes = 0;
+		uint64_t TTHits = 0;
+		uint64_t TTCutoffs = 0;
+
+		uint64_t BetaCutoffs = 0;
+		std::array<uint64_t, MoveIndexBuckets> CutoffsByMoveIndex = {};
+
+		uint64_t NullMoveSearches = 0;
+		uint64_t NullMoveCutoffs = 0;
+		uint64_t ReducedSearches = 0;
+		uint64_t ReducedReSearches = 0; // Reduced moves that beat alpha and had to be searched again
+
+		uint64_t TablebaseHits = 0;
+
+		uint64_t PawnTableProbes = 0;
+		uint64_t PawnTableHits = 0;
+
+		uint64_t EvalCacheProbes = 0;
+		uint64_t EvalCacheHits = 0;
+
+		uint64_t Evaluations = 0; // Calls to the evaluator, after the eval cache
+		uint64_t LazyEvaluations = 0; // Evaluations that stopped early outside the window
+
+		// Nodes spent on each completed iteration, indexed by depth
+		std::array<uint64_t, MaxPly> IterationNodes = {};
+
+		SearchStats& operator+=(const SearchStats& other);
+
+		uint64_t NodesPerSecond() const { return Nodes * 1000 / std::max<int64_t>(Time.count(), 1); }
+		double TTHitRate() const { return Ratio(TTHits, TTProbes); }
+		double PawnTableHitRate() const { return Ratio(PawnTableHits, PawnTableProbes); }
+		double EvalCacheHitRate() const { return Ratio(EvalCacheHits, EvalCacheProbes); }
+		double LazyEvaluationRate() const { return Ratio(LazyEvaluations, Evaluations); }
+		double FirstMoveCutoffRate() const { return Ratio(CutoffsByMoveIndex[0], BetaCutoffs); }
+		double NullMoveSuccessRate() const { return Ratio(NullMoveCutoffs, NullMoveSearches); }
+		double ReductionSuccessRate() const { return 1.0 - Ratio(ReducedReSearches, ReducedSearches); }
+
+		// Growth of the iteration's node count over the previous one, 0 if either is missing
+		double EffectiveBranchingFactor(int depth) const;
+	private:
+		static double Ratio(uint64_t count, uint64_t total) { return total ? (double)count / total : 0.0; }
+	};
+
+}
+
+namespace std {
+
+	std::ostream& operator<<(std::ostream& os, const Valor::Engine::SearchStats& stats);
+
+}
@@ -0,0 +1,1188 @@
+#include "vlpch.h"
+#include "Valor/Engine/Tablebase/SyzygyTablebase.h"
+
+#include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+
+// Reader for Ronald de Man's Syzygy tablebases (https://github.com/syzygy1/tb). A table stores one value per
+// position index, where the index numbers the placements of the pieces left after using the board's symmetries.
+// The values are compressed by repeatedly replacing frequent pairs of symbols with new ones, then coded with
+// canonical Huffman codes into fixed size blocks. How captures and the side to move are handled around the
+// tables follows the probing code published with the generator.
+
+namespace Valor::Engine {
+
+	constexpr int MaxTablePieces = 7;
+
+	constexpr uint8_t WDLMagic[4] = { 0x71, 0xE8, 0x23, 0x5D };
+	constexpr uint8_t DTZMagic[4] = { 0xD7, 0x66, 0x0C, 0xA5 };
+
+	// Header flags of a file
+	enum FileFlag : uint8_t
+	{
+		SplitFlag = 1, // Both sides to move are stored
+		PawnFlag = 2   // Split into four subtables by the file of the leading pawn
+	};
+
+	// Flags of a subtable, DTZ only except ConstantFlag
+	enum SubtableFlag : uint8_t
+	{
+		StoredSideFlag = 1, // Side to move a DTZ table stores, 0 for the table's white
+		MappedFlag = 2,     // Values go through the maps below
+		WinPliesFlag = 4,   // Wins are stored in plies rather than moves
+		LossPliesFlag = 8,
+		WideMapFlag = 16,   // Maps hold 16 bit values
+		ConstantFlag = 128  // Every position has the same value
+	};
+
+	static int RankOf(int square) { return square >> 3; }
+	static int FileOf(int square) { return square & 7; }
+	static int Diagonal(int square) { return RankOf(square) - FileOf(square); } // Above the a1-h8 diagonal if positive
+	static int MirrorFile(int square) { return square ^ 7; }
+	static int MirrorRank(int square) { return square ^ 56; }
+	static int Transpose(int square) { return (square >> 3) | ((square & 7) << 3); }
+
+	// Numberings of squares and square sets the position index is built from
+	struct IndexTables
+	{
+		int Triangle[64];       // a1-d1-d4 triangle: b1, c1, d1, c2, d2, d3 as 0-5, then a1, b2, c3, d4 as 6-9
+		int BelowDiagonal[64];  // The 28 squares below the a1-h8 diagonal
+		int KingPair[10][64];   // The 462 placements of two kings, the first in the triangle
+		uint64_t Choose[MaxTablePieces][65];
+
+		int PawnRank[64];       // a2-h7 from 47 down, edge files and low ranks first; the leading pawn ranks highest
+		uint64_t LeadPawnOffset[MaxTablePieces][64];
+		uint64_t LeadPawnPlacements[MaxTablePieces][4]; // Per file of the leading pawn
+	};
+
+	static const IndexTables s_Index = []()
+	{
+		IndexTables tables{};
+
+		std::array<int, 10> triangleSquares = { 1, 2, 3, 10, 11, 19, 0, 9, 18, 27 };
+		std::fill(std::begin(tables.Triangle), std::end(tables.Triangle), -1);
+		for (int i = 0; i < 10; i++)
+			tables.Triangle[triangleSquares[i]] = i;
+
+		int below = 0;
+		for (int square = 0; square < 64; square++)
+			tables.BelowDiagonal[square] = Diagonal(square) < 0 ? below++ : -1;
+
+		// With the first king on the diagonal the second isn't above it; placements with both on it come last
+		int pair = 0;
+		std::vector<std::pair<int, int>> bothOnDiagonal;
+		for (int i = 0; i < 10; i++)
+		{
+			int first = triangleSquares[i];
+			for (int second = 0; second < 64; second++)
+			{
+				tables.KingPair[i][second] = -1;
+				if (std::abs(RankOf(first) - RankOf(second)) <= 1 && std::abs(FileOf(first) - FileOf(second)) <= 1)
+					continue;
+
+				if (Diagonal(first) != 0)
+					tables.KingPair[i][second] = pair++;
+				else if (Diagonal(second) < 0)
+					tables.KingPair[i][second] = pair++;
+				else if (Diagonal(second) == 0)
+					bothOnDiagonal.emplace_back(i, second);
+			}
+		}
+		for (auto [i, second] : bothOnDiagonal)
+			tables.KingPair[i][second] = pair++;
+
+		for (int n = 0; n <= 64; n++)
+		{
+			tables.Choose[0][n] = 1;
+			for (int k = 1; k < MaxTablePieces; k++)
+				tables.Choose[k][n] = n == 0 ? 0 : tables.Choose[k][n - 1] + tables.Choose[k - 1][n - 1];
+		}
+
+		for (int square = 0; square < 64; square++)
+		{
+			int file = FileOf(square);
+			int rank = RankOf(square);
+			tables.PawnRank[square] = rank < 1 || rank > 6 ? 0 : 47 - 2 * (6 * std::min(file, 7 - file) + rank - 1) - (file > 3);
+		}
+
+		// The leading pawn's placements come in rank order, each followed by the placements of the other leading
+		// pawns on the squares ranking below it
+		for (int leadPawns = 1; leadPawns < MaxTablePieces; leadPawns++)
+		{
+			for (int file = 0; file < 4; file++)
+			{
+				uint64_t offset = 0;
+				for (int rank = 1; rank < 7; rank++)
+				{
+					int square = rank * 8 + file;
+					tables.LeadPawnOffset[leadPawns][square] = offset;
+					offset += tables.Choose[leadPawns - 1][tables.PawnRank[square]];
+				}
+				tables.LeadPawnPlacements[leadPawns][file] = offset;
+			}
+		}
+
+		return tables;
+	}();
+
+	// Reads the header fields, which are little-endian, and fails instead of reading past the end of the file
+	class ByteCursor
+	{
+	public:
+		ByteCursor(const uint8_t* begin, const uint8_t* end) : m_Begin(begin), m_Position(begin), m_End(end) {}
+
+		bool HasFailed() const { return m_HasFailed; }
+		const uint8_t* GetPosition() const { return m_Position; }
+
+		const uint8_t* Take(uint64_t size)
+		{
+			if (m_HasFailed || size > uint64_t(m_End - m_Position))
+			{
+				m_HasFailed = true;
+				return m_End;
+			}
+
+			const uint8_t* data = m_Position;
+			m_Position += size;
+			return data;
+		}
+
+		uint8_t Byte() { const uint8_t* data = Take(1); return m_HasFailed ? 0 : data[0]; }
+		uint16_t LE16() { const uint8_t* data = Take(2); return m_HasFailed ? 0 : uint16_t(data[0] | data[1] << 8); }
+		uint32_t LE32() { return LE16() | uint32_t(LE16()) << 16; }
+
+		// Alignment is relative to the start of the file
+		void Align(uint64_t alignment) { Take((alignment - uint64_t(m_Position - m_Begin) % alignment) % alignment); }
+	private:
+		const uint8_t* m_Begin;
+		const uint8_t* m_Position;
+		const uint8_t* m_End;
+		bool m_HasFailed = false;
+	};
+
+	static uint16_t ReadLE16(const uint8_t* data) { return uint16_t(data[0] | data[1] << 8); }
+	static uint32_t ReadLE32(const uint8_t* data) { return ReadLE16(data) | uint32_t(ReadLE16(data + 2)) << 16; }
+	static uint32_t ReadBE32(const uint8_t* data) { return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 | uint32_t(data[2]) << 8 | data[3]; }
+
+	// Values of one subtable, in blocks of Huffman coded symbols. A symbol either is a value or stands for a pair
+	// of symbols, so it expands to one or more consecutive values.
+	class CompressedValues
+	{
+	public:
+		void ReadHeader(ByteCursor& cursor, uint64_t valueCount)
+		{
+			m_Flags = cursor.Byte();
+			if (m_Flags & ConstantFlag)
+			{
+				m_Constant = cursor.Byte();
+				return;
+			}
+
+			m_BlockSize = uint64_t(1) << std::min<int>(cursor.Byte(), 31);
+			m_Span = uint64_t(1) << std::min<int>(cursor.Byte(), 31);
+			m_SparseEntries = (valueCount + m_Span - 1) / m_Span;
+			int padding = cursor.Byte();
+			m_BlockCount = cursor.LE32();
+			m_BlockLengthEntries = uint64_t(m_BlockCount) + padding; // Padded so the sparse index never points past the end
+
+			m_MaxCodeLength = cursor.Byte();
+			m_MinCodeLength = cursor.Byte();
+			if (m_MinCodeLength < 1 || m_MaxCodeLength < m_MinCodeLength || m_MaxCodeLength > 32)
+			{
+				cursor.Take(UINT64_MAX);
+				return;
+			}
+
+			// Canonical code: the codes of each length follow on from the longer ones, and the longest codes
+			// get the lowest symbols. `m_CodeBase` holds each length's first code, left aligned in 64 bits.
+			int lengths = m_MaxCodeLength - m_MinCodeLength + 1;
+			m_FirstSymbol.resize(lengths);
+			for (int i = 0; i < lengths; i++)
+				m_FirstSymbol[i] = cursor.LE16();
+
+			m_CodeBase.assign(lengths, 0);
+			for (int i = lengths - 2; i >= 0; i--)
+				m_CodeBase[i] = (m_CodeBase[i + 1] + m_FirstSymbol[i] - m_FirstSymbol[i + 1]) / 2;
+			for (int i = 0; i < lengths; i++)
+				m_CodeBase[i] <<= 64 - (m_MinCodeLength + i);
+
+			int symbolCount = cursor.LE16();
+			m_Tree = cursor.Take(3 * uint64_t(symbolCount));
+			cursor.Take(symbolCount & 1);
+			if (cursor.HasFailed())
+				return;
+
+			m_ValueCounts.assign(symbolCount, 0);
+			for (int symbol = 0; symbol < symbolCount; symbol++)
+				if (!CountValues(symbol))
+					cursor.Take(UINT64_MAX);
+		}
+
+		void ReadSparseIndex(ByteCursor& cursor) { m_SparseIndex = cursor.Take(6 * m_SparseEntries); }
+		void ReadBlockLengths(ByteCursor& cursor) { m_BlockLengths = cursor.Take(2 * m_BlockLengthEntries); }
+
+		void ReadBlocks(ByteCursor& cursor)
+		{
+			if (m_Flags & ConstantFlag)
+				return;
+
+			cursor.Align(64);
+			m_Blocks = cursor.Take(m_BlockCount * m_BlockSize);
+		}
+
+		uint8_t GetFlags() const { return m_Flags; }
+
+		int Get(uint64_t index) const
+		{
+			if (m_Flags & ConstantFlag)
+				return m_Constant;
+
+			// The sparse index gives the block and position of the value in the middle of every span
+			uint64_t entry = index / m_Span;
+			uint32_t block = ReadLE32(m_SparseIndex + 6 * entry);
+			int64_t position = int64_t(ReadLE16(m_SparseIndex + 6 * entry + 4)) + int64_t(index % m_Span) - int64_t(m_Span / 2);
+
+			while (position < 0)
+				position += BlockValues(--block);
+			while (position >= BlockValues(block))
+				position -= BlockValues(block++);
+
+			// Skip the symbols expanding to earlier values
+			BitReader reader(m_Blocks + block * m_BlockSize);
+			int symbol = ReadSymbol(reader);
+			while (position >= m_ValueCounts[symbol])
+			{
+				position -= m_ValueCounts[symbol];
+				symbol = ReadSymbol(reader);
+			}
+
+			// Then walk down the pairs to the value
+			while (m_ValueCounts[symbol] > 1)
+			{
+				int left = LeftSymbol(symbol);
+				if (position < m_ValueCounts[left])
+				{
+					symbol = left;
+				}
+				else
+				{
+					position -= m_ValueCounts[left];
+					symbol = RightSymbol(symbol);
+				}
+			}
+
+			return LeftSymbol(symbol);
+		}
+	private:
+		// Big-endian bit stream, refilled 32 bits at a time
+		struct BitReader
+		{
+			const uint8_t* Data;
+			uint64_t Bits;
+			int Available = 64;
+
+			explicit BitReader(const uint8_t* data) : Data(data + 8), Bits(uint64_t(ReadBE32(data)) << 32 | ReadBE32(data + 4)) {}
+
+			void Consume(int count)
+			{
+				Bits <<= count;
+				Available -= count;
+				if (Available <= 32)
+				{
+					Bits |= uint64_t(ReadBE32(Data)) << (32 - Available);
+					Data += 4;
+					Available += 32;
+				}
+			}
+		};
+
+		int ReadSymbol(BitReader& reader) const
+		{
+			int i = 0;
+			while (reader.Bits < m_CodeBase[i])
+				i++;
+
+			int length = m_MinCodeLength + i;
+			int symbol = m_FirstSymbol[i] + int((reader.Bits - m_CodeBase[i]) >> (64 - length));
+			reader.Consume(length);
+			return symbol;
+		}
+
+		// Each tree node holds two 12 bit symbols; a right symbol of 0xFFF marks a value, stored on the left
+		int LeftSymbol(int symbol) const { const uint8_t* node = m_Tree + 3 * symbol; return node[0] | (node[1] & 0xF) << 8; }
+		int RightSymbol(int symbol) const { const uint8_t* node = m_Tree + 3 * symbol; return node[1] >> 4 | node[2] << 4; }
+
+		int BlockValues(uint32_t block) const { return ReadLE16(m_BlockLengths + 2 * uint64_t(block)) + 1; }
+
+		bool CountValues(int symbol)
+		{
+			if (m_ValueCounts[symbol])
+				return true;
+
+			// Marks the symbol while its pairs are counted, so a malformed tree can't recurse forever
+			m_ValueCounts[symbol] = -1;
+
+			int left = LeftSymbol(symbol);
+			int right = RightSymbol(symbol);
+			if (right == 0xFFF)
+			{
+				m_ValueCounts[symbol] = 1;
+				return true;
+			}
+
+			int count = int(m_ValueCounts.size());
+			if (left >= count || right >= count || !CountValues(left) || !CountValues(right) || m_ValueCounts[left] < 0 || m_ValueCounts[right] < 0)
+				return false;
+
+			m_ValueCounts[symbol] = m_ValueCounts[left] + m_ValueCounts[right];
+			return true;
+		}
+	private:
+		uint8_t m_Flags = 0;
+		uint8_t m_Constant = 0;
+
+		uint64_t m_BlockSize = 0;
+		uint64_t m_Span = 0;
+		uint32_t m_BlockCount = 0;
+		uint64_t m_SparseEntries = 0;
+		uint64_t m_BlockLengthEntries = 0;
+
+		int m_MinCodeLength = 0;
+		int m_MaxCodeLength = 0;
+		std::vector<uint64_t> m_CodeBase;
+		std::vector<int> m_FirstSymbol;
+		std::vector<int> m_ValueCounts; // Values each symbol expands to
+
+		const uint8_t* m_Tree = nullptr;
+		const uint8_t* m_SparseIndex = nullptr;
+		const uint8_t* m_BlockLengths = nullptr;
+		const uint8_t* m_Blocks = nullptr;
+	};
+
+	// One side to move and, in pawn tables, file of the leading pawn
+	struct Subtable
+	{
+		// Piece codes in index order: 1-6 white pawn to king, 9-14 black
+		uint8_t Pieces[MaxTablePieces] = {};
+
+		// The pieces form groups, each indexed as one combination of squares and weighted by its factor
+		int GroupLengths[MaxTablePieces] = {};
+		uint64_t GroupFactors[MaxTablePieces] = {};
+		int GroupCount = 0;
+		uint64_t Size = 0;
+
+		uint16_t MapOffsets[4] = {}; // DTZ only: where each result's map starts
+		CompressedValues Values;
+	};
+
+	enum class TableType { WDL, DTZ };
+
+	struct SyzygyTablebase::Table
+	{
+		TableType Type = TableType::WDL;
+		std::string Path;
+
+		uint64_t Key = 0;        // Material with the table's white pieces on White
+		uint64_t SwappedKey = 0; // ...and on Black
+		int PieceCount = 0;
+		bool HasPawns = false;
+		bool HasUniquePieces = false;
+		int PawnCounts[2] = {}; // Leading color first
+
+		std::once_flag MapOnce;
+		bool IsMapped = false;
+		MappedFile File;
+
+		int SideCount = 1;
+		const uint8_t* Maps = nullptr; // DTZ only
+		Subtable Subtables[4][2];      // [leading pawn file][side to move]
+
+		bool IsSymmetric() const { return Key == SwappedKey; }
+		const Subtable& Get(int file, int stm) const { return Subtables[HasPawns ? file : 0][stm % SideCount]; }
+	};
+
+	using Table = SyzygyTablebase::Table;
+
+	// Piece counts, four bits per piece type and color
+	static uint64_t MaterialKey(const Board& board)
+	{
+		uint64_t key = 0;
+		for (int color = 0; color < 2; color++)
+			for (int type = 0; type < 6; type++)
+				key |= uint64_t(std::popcount(board.GetPieceBitboard(color == 0, PieceType(type)))) << (4 * (color * 6 + type));
+		return key;
+	}
+
+	// Fills in the material of a table from its name, like "KRPvKR"
+	static void SetMaterial(Table& table, const std::string& code)
+	{
+		constexpr std::string_view PieceLetters = "PNBRQK";
+
+		int counts[2][6] = {};
+		int color = 0;
+		for (char c : code)
+		{
+			if (c == 'v')
+				color = 1;
+			else
+				counts[color][PieceLetters.find(c)]++;
+		}
+
+		for (int side = 0; side < 2; side++)
+		{
+			for (int type = 0; type < 6; type++)
+			{
+				table.Key |= uint64_t(counts[side][type]) << (4 * (side * 6 + type));
+				table.SwappedKey |= uint64_t(counts[side][type]) << (4 * ((1 - side) * 6 + type));
+				table.PieceCount += counts[side][type];
+				table.HasUniquePieces |= type != int(PieceType::King) && counts[side][type] == 1;
+			}
+		}
+
+		// With pawns on both sides the one with fewer leads, or White if they have as many
+		int whitePawns = counts[0][int(PieceType::Pawn)];
+		int blackPawns = counts[1][int(PieceType::Pawn)];
+		bool isWhiteLeading = whitePawns && (!blackPawns || whitePawns <= blackPawns);
+		table.HasPawns = whitePawns || blackPawns;
+		table.PawnCounts[0] = isWhiteLeading ? whitePawns : blackPawns;
+		table.PawnCounts[1] = isWhiteLeading ? blackPawns : whitePawns;
+	}
+
+	// Splits the pieces into groups: the leading group (two kings, three unique pieces, or the leading pawns),
+	// the other side's pawns if both sides have some, then each run of identical pieces. `order` gives the
+	// positions of the first two among the factors; the rest fill the other positions in turn.
+	static bool SetGroups(const Table& table, Subtable& subtable, const int order[2], int file)
+	{
+		const IndexTables& e = s_Index;
+
+		int leadLength = table.HasPawns ? table.PawnCounts[0] : table.HasUniquePieces ? 3 : 2;
+		subtable.GroupCount = 0;
+		for (int i = 0; i < table.PieceCount; i += subtable.GroupLengths[subtable.GroupCount++])
+		{
+			int length = i == 0 ? leadLength : 1;
+			while (i > 0 && i + length < table.PieceCount && subtable.Pieces[i + length] == subtable.Pieces[i])
+				length++;
+			subtable.GroupLengths[subtable.GroupCount] = length;
+		}
+
+		bool hasOtherPawns = table.HasPawns && table.PawnCounts[1];
+		int freeSquares = 64 - subtable.GroupLengths[0] - (hasOtherPawns ? subtable.GroupLengths[1] : 0);
+		int next = hasOtherPawns ? 2 : 1;
+		uint64_t factor = 1;
+
+		for (int position = 0; position < subtable.GroupCount; position++)
+		{
+			int group;
+			uint64_t placements;
+			if (position == order[0])
+			{
+				group = 0;
+				placements = table.HasPawns ? e.LeadPawnPlacements[subtable.GroupLengths[0]][file] : table.HasUniquePieces ? 31332 : 462;
+			}
+			else if (position == order[1])
+			{
+				group = 1;
+				placements = e.Choose[subtable.GroupLengths[1]][48 - subtable.GroupLengths[0]];
+			}
+			else if (next < subtable.GroupCount)
+			{
+				group = next++;
+				placements = e.Choose[subtable.GroupLengths[group]][freeSquares];
+				freeSquares -= subtable.GroupLengths[group];
+			}
+			else
+			{
+				return false;
+			}
+
+			subtable.GroupFactors[group] = factor;
+			factor *= placements;
+		}
+
+		subtable.Size = factor;
+		return next == subtable.GroupCount;
+	}
+
+	// Lays the subtables out over the mapped file, in the order the sections follow each other
+	static bool ReadLayout(Table& table)
+	{
+		ByteCursor cursor(table.File.GetData(), table.File.GetData() + table.File.GetSize() - 16); // Checksum at the end
+		cursor.Take(4);
+
+		uint8_t fileFlags = cursor.Byte();
+		if (bool(fileFlags & PawnFlag) != table.HasPawns)
+			return false;
+
+		table.SideCount = table.Type == TableType::WDL && (fileFlags & SplitFlag) ? 2 : 1;
+		int files = table.HasPawns ? 4 : 1;
+		bool hasOtherPawns = table.HasPawns && table.PawnCounts[1];
+
+		// Per file: one nibble per side for the order of the groups, then one per piece
+		for (int file = 0; file < files; file++)
+		{
+			uint8_t order = cursor.Byte();
+			uint8_t otherOrder = hasOtherPawns ? cursor.Byte() : 0xFF;
+			const uint8_t* pieces = cursor.Take(table.PieceCount);
+			if (cursor.HasFailed())
+				return false;
+
+			for (int side = 0; side < table.SideCount; side++)
+			{
+				Subtable& subtable = table.Subtables[file][side];
+				int shift = side ? 4 : 0;
+				for (int i = 0; i < table.PieceCount; i++)
+					subtable.Pieces[i] = (pieces[i] >> shift) & 0xF;
+
+				int groupOrder[2] = { (order >> shift) & 0xF, (otherOrder >> shift) & 0xF };
+				if (!SetGroups(table, subtable, groupOrder, file))
+					return false;
+			}
+		}
+		cursor.Align(2);
+
+		for (int file = 0; file < files; file++)
+			for (int side = 0; side < table.SideCount; side++)
+				table.Subtables[file][side].Values.ReadHeader(cursor, table.Subtables[file][side].Size);
+
+		// DTZ values are stored by frequency per result; these maps turn them back into distances
+		if (table.Type == TableType::DTZ)
+		{
+			table.Maps = cursor.GetPosition();
+			for (int file = 0; file < files; file++)
+			{
+				Subtable& subtable = table.Subtables[file][0];
+				if (!(subtable.Values.GetFlags() & MappedFlag))
+					continue;
+
+				bool isWide = subtable.Values.GetFlags() & WideMapFlag;
+				if (isWide)
+					cursor.Align(2);
+
+				for (int i = 0; i < 4; i++)
+				{
+					int count = isWide ? cursor.LE16() : cursor.Byte();
+					subtable.MapOffsets[i] = uint16_t(cursor.GetPosition() - table.Maps);
+					cursor.Take(uint64_t(count) * (isWide ? 2 : 1));
+				}
+			}
+			cursor.Align(2);
+		}
+
+		for (int file = 0; file < files; file++)
+			for (int side = 0; side < table.SideCount; side++)
+				table.Subtables[file][side].Values.ReadSparseIndex(cursor);
+
+		for (int file = 0; file < files; file++)
+			for (int side = 0; side < table.SideCount; side++)
+				table.Subtables[file][side].Values.ReadBlockLengths(cursor);
+
+		for (int file = 0; file < files; file++)
+			for (int side = 0; side < table.SideCount; side++)
+				table.Subtables[file][side].Values.ReadBlocks(cursor);
+
+		return !cursor.HasFailed();
+	}
+
+	static bool MapTable(Table& table)
+	{
+		std::call_once(table.MapOnce, [&table]()
+		{
+			if (!table.File.Open(table.Path))
+				return;
+
+			// The data is 64 byte aligned, followed by a 16 byte checksum
+			const uint8_t* magic = table.Type == TableType::WDL ? WDLMagic : DTZMagic;
+			if (table.File.GetSize() % 64 != 16 || !std::equal(magic, magic + 4, table.File.GetData()) || !ReadLayout(table))
+			{
+				std::cerr << "Corrupted tablebase file " << table.Path << std::endl;
+				table.File.Close();
+				return;
+			}
+
+			table.IsMapped = true;
+		});
+
+		return table.IsMapped;
+	}
+
+	// Index of the leading group of a pawnless table, with the first piece already in the a1-d1-d4 triangle
+	static uint64_t LeadPiecesIndex(const Table& table, const int* squares)
+	{
+		const IndexTables& e = s_Index;
+
+		if (!table.HasUniquePieces)
+			return e.KingPair[e.Triangle[squares[0]]][squares[1]];
+
+		// Three unique pieces, numbered by how many of them lead on the diagonal: off it, the first takes the
+		// triangle's 6 squares, and each later piece the squares not taken by the earlier ones
+		int s0 = squares[0];
+		int s1 = squares[1];
+		int s2 = squares[2];
+		int after1 = s1 > s0;
+		int after2 = (s2 > s0) + (s2 > s1);
+
+		if (Diagonal(s0))
+			return (uint64_t(e.Triangle[s0]) * 63 + (s1 - after1)) * 62 + (s2 - after2);
+		if (Diagonal(s1))
+			return (6 * 63 + uint64_t(RankOf(s0)) * 28 + e.BelowDiagonal[s1]) * 62 + (s2 - after2);
+
+		uint64_t index = 6 * 63 * 62 + 4 * 28 * 62;
+		if (Diagonal(s2))
+			return index + (uint64_t(RankOf(s0)) * 7 + (RankOf(s1) - after1)) * 28 + e.BelowDiagonal[s2];
+
+		index += 4 * 7 * 28;
+		return index + (uint64_t(RankOf(s0)) * 7 + (RankOf(s1) - after1)) * 6 + (RankOf(s2) - after2);
+	}
+
+	// Value stored for `board`. DTZ tables only store one side to move; for the other, `isOtherSide` is set.
+	static std::optional<int> LookUp(const Board& board, const Table& table, WDLScore wdl, bool* isOtherSide)
+	{
+		const IndexTables& e = s_Index;
+
+		// Tables hold the stronger side as white, and symmetric ones only White to move; otherwise the
+		// colors are swapped and the board flipped
+		bool isFlipped = table.IsSymmetric() ? !board.IsWhiteTurn() : MaterialKey(board) != table.Key;
+		int stm = table.IsSymmetric() ? 0 : int(isFlipped) ^ int(!board.IsWhiteTurn());
+		int squareFlip = isFlipped ? 56 : 0;
+
+		int squares[MaxTablePieces];
+		int count = 0;
+		int file = 0;
+		uint64_t placed = 0;
+
+		// Pawn tables are split by the file of the leading pawn, mirrored onto files a-d
+		int leadPawns = 0;
+		if (table.HasPawns)
+		{
+			bool isLeadWhite = (table.Get(0, 0).Pieces[0] < 8) != isFlipped;
+			uint64_t pawns = board.Pawns(isLeadWhite);
+			if (std::popcount(pawns) != table.PawnCounts[0])
+				return std::nullopt;
+
+			placed |= pawns;
+			for (; pawns; pawns &= pawns - 1)
+				squares[count++] = std::countr_zero(pawns) ^ squareFlip;
+
+			leadPawns = count;
+			std::swap(squares[0], *std::max_element(squares, squares + count, [&e](int a, int b) { return e.PawnRank[a] < e.PawnRank[b]; }));
+			file = std::min(FileOf(squares[0]), 7 - FileOf(squares[0]));
+		}
+
+		// Symmetric tables only hold White to move, so their stored side says nothing
+		const Subtable& subtable = table.Get(file, stm);
+		if (table.Type == TableType::DTZ && (subtable.Values.GetFlags() & StoredSideFlag) != stm && !table.IsSymmetric())
+		{
+			if (isOtherSide)
+				*isOtherSide = true;
+			return std::nullopt;
+		}
+
+		// The other pieces in the table's order
+		for (; count < table.PieceCount; count++)
+		{
+			int code = subtable.Pieces[count];
+			uint64_t pieces = board.GetPieceBitboard(((code >> 3) != 0) == isFlipped, PieceType((code & 7) - 1)) & ~placed;
+			if (!pieces)
+				return std::nullopt;
+
+			int square = std::countr_zero(pieces);
+			placed |= 1ull << square;
+			squares[count] = square ^ squareFlip;
+		}
+
+		if (FileOf(squares[0]) > 3)
+			for (int i = 0; i < count; i++)
+				squares[i] = MirrorFile(squares[i]);
+
+		uint64_t index;
+		if (table.HasPawns)
+		{
+			// The other leading pawns as a combination of the squares ranking below the leader
+			std::stable_sort(squares + 1, squares + leadPawns, [&e](int a, int b) { return e.PawnRank[a] < e.PawnRank[b]; });
+			index = e.LeadPawnOffset[leadPawns][squares[0]];
+			for (int i = 1; i < leadPawns; i++)
+				index += e.Choose[i][e.PawnRank[squares[i]]];
+		}
+		else
+		{
+			// Pawnless tables also use the rank and diagonal symmetries: the first piece goes to ranks 1-4,
+			// then the first of the leading group off the diagonal goes below it
+			if (RankOf(squares[0]) > 3)
+				for (int i = 0; i < count; i++)
+					squares[i] = MirrorRank(squares[i]);
+
+			for (int i = 0; i < subtable.GroupLengths[0]; i++)
+			{
+				if (Diagonal(squares[i]) > 0)
+					for (int j = 0; j < count; j++)
+						squares[j] = Transpose(squares[j]);
+				if (Diagonal(squares[i]))
+					break;
+			}
+
+			index = LeadPiecesIndex(table, squares);
+		}
+		index *= subtable.GroupFactors[0];
+
+		// Each later group as a combination of the squares the earlier groups leave. The other side's pawns
+		// only have the 48 squares of ranks 2-7.
+		int start = subtable.GroupLengths[0];
+		for (int group = 1; group < subtable.GroupCount; group++)
+		{
+			int length = subtable.GroupLengths[group];
+			int* groupSquares = squares + start;
+			std::stable_sort(groupSquares, groupSquares + length);
+
+			int skipped = group == 1 && table.HasPawns && table.PawnCounts[1] ? 8 : 0;
+			uint64_t combination = 0;
+			for (int i = 0; i < length; i++)
+			{
+				int taken = int(std::count_if(squares, groupSquares, [&](int square) { return square < groupSquares[i]; }));
+				combination += e.Choose[i + 1][groupSquares[i] - taken - skipped];
+			}
+
+			index += combination * subtable.GroupFactors[group];
+			start += length;
+		}
+
+		if (index >= subtable.Size)
+			return std::nullopt;
+
+		int value = subtable.Values.Get(index);
+		if (table.Type == TableType::WDL)
+			return value - 2;
+
+		uint8_t flags = subtable.Values.GetFlags();
+		if (flags & MappedFlag)
+		{
+			// The maps are stored for wins, losses, cursed wins and blessed losses
+			int map = wdl == WDLScore::Win ? 0 : wdl == WDLScore::Loss ? 1 : wdl == WDLScore::CursedWin ? 2 : 3;
+			const uint8_t* entries = table.Maps + subtable.MapOffsets[map];
+			value = (flags & WideMapFlag) ? ReadLE16(entries + 2 * value) : entries[value];
+		}
+
+		// Tables not stored in plies count moves, which can leave a distance a ply short
+		bool isInPlies = (wdl == WDLScore::Win && (flags & WinPliesFlag)) || (wdl == WDLScore::Loss && (flags & LossPliesFlag));
+		return (isInPlies ? value : 2 * value) + 1;
+	}
+
+	static bool IsZeroingMove(const Board& board, const Move& move)
+	{
+		return move.IsCapture() || (board.Pawns() & (1ull << move.Source));
+	}
+
+	static bool IsMate(const Board& board)
+	{
+		return board.IsCheck() && MoveGeneratorSimple::GenerateLegalMoves(board).empty();
+	}
+
+	// DTZ of a position whose best move resets the fifty-move counter
+	static int DTZBeforeZeroing(WDLScore wdl)
+	{
+		switch (wdl)
+		{
+			case WDLScore::Win:         return 1;
+			case WDLScore::CursedWin:   return 101;
+			case WDLScore::BlessedLoss: return -101;
+			case WDLScore::Loss:        return -1;
+			default:                    return 0;
+		}
+	}
+
+	static int Sign(int value) { return (value > 0) - (value < 0); }
+
+	static bool HasCastlingRights(const Board& board)
+	{
+		return board.CanCastle(true, true) || board.CanCastle(true, false) || board.CanCastle(false, true) || board.CanCastle(false, false);
+	}
+
+	// Positions with results known from the endgames themselves, to catch a decoder that misreads real tables.
+	// DTZ is in plies; tables counting moves may give one ply less.
+	struct ReferencePosition
+	{
+		const char* FEN;
+		WDLScore WDL;
+		int DTZ;
+	};
+
+	static constexpr ReferencePosition ReferencePositions[] = {
+		// Longest wins and losses, draws, black as the stronger side and pawns on both halves of the board
+		{ "8/8/8/5k2/8/8/1Q6/K7 w - - 0 1", WDLScore::Win, 19 },
+		{ "8/4k3/8/8/8/8/1Q6/K7 b - - 0 1", WDLScore::Loss, -20 },
+		{ "k7/1q6/8/8/5K2/8/8/8 b - - 0 1", WDLScore::Win, 19 },
+		{ "8/8/8/8/8/8/8/K1Qk4 b - - 0 1", WDLScore::Draw, 0 },
+		{ "8/6R1/5k2/8/8/8/8/1K6 w - - 0 1", WDLScore::Win, 31 },
+		{ "8/5R2/8/5k2/8/8/8/1K6 b - - 0 1", WDLScore::Loss, -32 },
+		{ "1k6/8/8/8/5K2/8/5r2/8 w - - 0 1", WDLScore::Loss, -32 },
+		{ "8/8/1k6/8/K7/6P1/8/8 w - - 0 1", WDLScore::Win, 19 },
+		{ "8/8/6k1/8/7K/1P6/8/8 w - - 0 1", WDLScore::Win, 19 },
+		{ "8/8/8/k7/8/K7/6P1/8 b - - 0 1", WDLScore::Loss, -20 },
+		{ "8/6p1/k7/8/K7/8/8/8 w - - 0 1", WDLScore::Loss, -20 },
+		{ "K7/8/8/5k2/8/8/7P/8 w - - 0 1", WDLScore::Draw, 0 },
+		{ "6R1/8/8/8/8/8/3K4/rk6 w - - 0 1", WDLScore::Win, 7 },
+		{ "8/8/2R5/1k6/3K3r/8/8/8 w - - 0 1", WDLScore::Loss, -6 },
+		{ "6R1/8/4k3/5r2/3K4/8/8/8 b - - 0 1", WDLScore::Draw, 0 },
+
+		// Rook and pawn against rook: mate in one, and every move allowing one
+		{ "3R4/8/7P/8/8/k1K5/8/7r w - - 0 1", WDLScore::Win, 1 },
+		{ "7R/8/K1k5/8/8/7p/8/3r4 b - - 0 1", WDLScore::Win, 1 },
+		{ "k1K5/8/8/8/8/1R1P4/8/7r w - - 0 1", WDLScore::Win, 1 },
+		{ "5kr1/8/4KP2/8/2R5/8/8/8 b - - 0 1", WDLScore::Loss, -2 },
+		{ "8/8/8/2r5/8/4kp2/8/5KR1 w - - 0 1", WDLScore::Loss, -2 },
+		{ "8/PK6/1R6/8/8/8/k7/r7 b - - 0 1", WDLScore::Loss, -2 },
+	};
+
+	SyzygyTablebase::SyzygyTablebase()
+	{
+	}
+
+	SyzygyTablebase::~SyzygyTablebase()
+	{
+	}
+
+	int SyzygyTablebase::Load(const std::string& paths)
+	{
+		Clear();
+
+#ifdef _WIN32
+		constexpr char Separator = ';';
+#else
+		constexpr char Separator = ':';
+#endif
+
+		std::vector<std::string> directories;
+		std::stringstream stream(paths);
+		for (std::string directory; std::getline(stream, directory, Separator);)
+			if (!directory.empty())
+				directories.push_back(directory);
+
+		if (directories.empty())
+			return 0;
+
+		// Every split of up to five non-king pieces between the sides, strongest pieces first like the file names
+		std::vector<std::string> sides = { "" };
+		for (size_t begin = 0; begin < sides.size(); begin++)
+		{
+			if (sides[begin].size() == MaxTablePieces - 2)
+				continue;
+
+			const std::string pieceOrder = "QRBNP";
+			size_t first = sides[begin].empty() ? 0 : pieceOrder.find(sides[begin].back());
+			for (size_t i = first; i < pieceOrder.size(); i++)
+				sides.push_back(sides[begin] + pieceOrder[i]);
+		}
+
+		for (const std::string& white : sides)
+			for (const std::string& black : sides)
+				if (!white.empty() && white.size() + black.size() <= MaxTablePieces - 2)
+					AddTable(directories, "K" + white + "vK" + black);
+
+		if (m_Tables.empty())
+			return 0;
+
+		if (!CheckReferencePositions())
+		{
+			Clear();
+			return 0;
+		}
+
+		int count = 0;
+		for (const std::unique_ptr<Table>& table : m_Tables)
+			count += table->Type == TableType::WDL;
+		return count;
+	}
+
+	void SyzygyTablebase::Clear()
+	{
+		m_TablesByMaterial.clear();
+		m_Tables.clear();
+		m_MaxPieces = 0;
+	}
+
+	void SyzygyTablebase::AddTable(const std::vector<std::string>& directories, const std::string& code)
+	{
+		auto findFile = [&directories](const std::string& name) -> std::string
+		{
+			for (const std::string& directory : directories)
+			{
+				std::filesystem::path path = std::filesystem::path(directory) / name;
+				std::error_code error;
+				if (std::filesystem::is_regular_file(path, error))
+					return path.string();
+			}
+			return {};
+		};
+
+		std::string wdlPath = findFile(code + ".rtbw");
+		if (wdlPath.empty())
+			return;
+
+		TablePair tables;
+		for (TableType type : { TableType::WDL, TableType::DTZ })
+		{
+			std::string path = type == TableType::WDL ? wdlPath : findFile(code + ".rtbz");
+			if (path.empty())
+				continue;
+
+			std::unique_ptr<Table> table = std::make_unique<Table>();
+			table->Type = type;
+			table->Path = path;
+			SetMaterial(*table, code);
+
+			(type == TableType::WDL ? tables.WDL : tables.DTZ) = table.get();
+			m_Tables.push_back(std::move(table));
+		}
+
+		// Only the first table found for a material counts, like the file search order
+		m_TablesByMaterial.try_emplace(tables.WDL->Key, tables);
+		m_TablesByMaterial.try_emplace(tables.WDL->SwappedKey, tables);
+		m_MaxPieces = std::max(m_MaxPieces, tables.WDL->PieceCount);
+	}
+
+	const SyzygyTablebase::TablePair* SyzygyTablebase::FindTables(const Board& board) const
+	{
+		auto it = m_TablesByMaterial.find(MaterialKey(board));
+		return it != m_TablesByMaterial.end() ? &it->second : nullptr;
+	}
+
+	bool SyzygyTablebase::CheckReferencePositions() const
+	{
+		for (const ReferencePosition& reference : ReferencePositions)
+		{
+			Board board;
+			Board::FromFEN(reference.FEN, board);
+
+			// The three piece tables come with every set, so they're what the decoder is always checked against
+			const TablePair* tables = FindTables(board);
+			if (!tables)
+			{
+				if (std::popcount(board.Occupied()) > 3)
+					continue;
+
+				std::cerr << "Syzygy tablebases need the three piece tables, which are checked on loading" << std::endl;
+				return false;
+			}
+
+			std::optional<WDLScore> wdl = ProbeWDL(board);
+			std::optional<int> dtz = ProbeDTZ(board);
+			bool isDTZCorrect = !tables->DTZ
+				|| (dtz && Sign(*dtz) == Sign(reference.DTZ) && (std::abs(*dtz) == std::abs(reference.DTZ) || std::abs(*dtz) + 1 == std::abs(reference.DTZ)));
+
+			if (wdl != reference.WDL || !isDTZCorrect)
+			{
+				std::cerr << "Syzygy tablebases give wrong results for " << reference.FEN << ", not using them" << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// WDL of `board`, searching captures before the table: the tables know nothing of en passant, and may store
+	// any value not above the best capture's. `isZeroingBest` tells whether a capture (or with `includePawnMoves`
+	// a pawn move) reaches the result, in which case the DTZ table may not hold it either.
+	std::optional<WDLScore> SyzygyTablebase::SearchWDL(const Board& board, bool includePawnMoves, bool& isZeroingBest) const
+	{
+		isZeroingBest = false;
+
+		std::vector<Move> moves = MoveGeneratorSimple::GenerateLegalMoves(board);
+		std::optional<WDLScore> bestZeroing;
+		size_t searched = 0;
+
+		for (const Move& move : moves)
+		{
+			if (!move.IsCapture() && !(includePawnMoves && IsZeroingMove(board, move)))
+				continue;
+
+			searched++;
+
+			Board tempBoard = board;
+			tempBoard.MakeMove(move);
+
+			bool isChildZeroingBest;
+			std::optional<WDLScore> childWDL = SearchWDL(tempBoard, false, isChildZeroingBest);
+			if (!childWDL)
+				return std::nullopt;
+
+			WDLScore value = WDLScore(-int(*childWDL));
+			if (value == WDLScore::Win)
+			{
+				isZeroingBest = true;
+				return value;
+			}
+			bestZeroing = std::max(bestZeroing.value_or(WDLScore::Loss), value);
+		}
+
+		// With every move searched the table isn't needed, and could be wrong if en passant is possible
+		if (searched && searched == moves.size())
+		{
+			isZeroingBest = true;
+			return bestZeroing;
+		}
+
+		std::optional<int> stored = ReadTable(board, false, WDLScore::Draw);
+		if (!stored)
+			return std::nullopt;
+
+		WDLScore value = WDLScore(*stored);
+		if (bestZeroing && *bestZeroing >= value)
+		{
+			isZeroingBest = *bestZeroing > WDLScore::Draw;
+			return bestZeroing;
+		}
+
+		return value;
+	}
+
+	std::optional<int> SyzygyTablebase::SearchDTZ(const Board& board) const
+	{
+		bool isZeroingBest;
+		std::optional<WDLScore> wdl = SearchWDL(board, true, isZeroingBest);
+		if (!wdl)
+			return std::nullopt;
+
+		// Draws aren't stored, nor positions whose best move resets the counter
+		if (*wdl == WDLScore::Draw || isZeroingBest)
+			return DTZBeforeZeroing(*wdl);
+
+		bool isOtherSide = false;
+		if (std::optional<int> stored = ReadTable(board, true, *wdl, &isOtherSide))
+			return (*stored + 100 * (*wdl == WDLScore::BlessedLoss || *wdl == WDLScore::CursedWin)) * Sign(int(*wdl));
+
+		if (!isOtherSide)
+			return std::nullopt;
+
+		// Only the other side to move is stored, so take the best reply one ply deeper
+		std::optional<int> best;
+		for (const Move& move : MoveGeneratorSimple::GenerateLegalMoves(board))
+		{
+			bool isZeroing = IsZeroingMove(board, move);
+
+			Board tempBoard = board;
+			tempBoard.MakeMove(move);
+
+			// A zeroing move's distance is that of the move itself, not of the sequence after it
+			int dtz;
+			if (isZeroing)
+			{
+				bool isChildZeroingBest;
+				std::optional<WDLScore> childWDL = SearchWDL(tempBoard, false, isChildZeroingBest);
+				if (!childWDL)
+					return std::nullopt;
+				dtz = -DTZBeforeZeroing(*childWDL);
+			}
+			else
+			{
+				std::optional<int> childDTZ = SearchDTZ(tempBoard);
+				if (!childDTZ)
+					return std::nullopt;
+				dtz = -*childDTZ;
+			}
+
+			// Mate counts as zeroing
+			if (!isZeroing && !(dtz == 1 && IsMate(tempBoard)))
+				dtz += Sign(dtz);
+
+			// Only moves keeping the result, fastest when winning and slowest when losing
+			if (Sign(dtz) == Sign(int(*wdl)) && (!best || dtz < *best))
+				best = dtz;
+		}
+
+		// No legal moves means mate
+		return best.value_or(-1);
+	}
+
+	std::optional<int> SyzygyTablebase::ReadTable(const Board& board, bool isDTZ, WDLScore wdl, bool* isOtherSide) const
+	{
+		if (std::popcount(board.Occupied()) == 2)
+			return int(WDLScore::Draw);
+
+		const TablePair* tables = FindTables(board);
+		Table* table = tables ? (isDTZ ? tables->DTZ : tables->WDL) : nullptr;
+		if (!table || !MapTable(*table))
+			return std::nullopt;
+
+		return LookUp(board, *table, wdl, isOtherSide);
+	}
+
+	std::optional<WDLScore> SyzygyTablebase::ProbeWDL(const Board& board) const
+	{
+		if (HasCastlingRights(board) || std::popcount(board.Occupied()) > m_MaxPieces)
+			return std::nullopt;
+
+		bool isZeroingBest;
+		return SearchWDL(board, false, isZeroingBest);
+	}
+
+	std::optional<int> SyzygyTablebase::ProbeDTZ(const Board& board) const
+	{
+		if (HasCastlingRights(board) || std::popcount(board.Occupied()) > m_MaxPieces)
+			return std::nullopt;
+
+		return SearchDTZ(board);
+	}
+
+	bool SyzygyTablebase::FilterRootMoves(const Board& board, std::vector<Move>& moves) const
+	{
+		if (moves.empty() || HasCastlingRights(board) || std::popcount(board.Occupied()) > m_MaxPieces)
+			return false;
+
+		// Real wins and losses rank furthest from 0, results the fifty-move rule turns into draws closer to it
+		constexpr int MaxRank = 1 << 18;
+		int halfmoves = board.GetHalfmoveCounter();
+
+		std::vector<int> ranks;
+		ranks.reserve(moves.size());
+
+		for (const Move& move : moves)
+		{
+			Board tempBoard = board;
+			tempBoard.MakeMove(move);
+
+			int dtz;
+			if (tempBoard.GetHalfmoveCounter() == 0)
+			{
+				bool isZeroingBest;
+				std::optional<WDLScore> wdl = SearchWDL(tempBoard, false, isZeroingBest);
+				if (!wdl)
+					return false;
+				dtz = DTZBeforeZeroing(WDLScore(-int(*wdl)));
+			}
+			else
+			{
+				std::optional<int> childDTZ = SearchDTZ(tempBoard);
+				if (!childDTZ)
+					return false;
+
+				// Mate counts as zeroing right away
+				dtz = IsMate(tempBoard) ? 1 : -*childDTZ + Sign(-*childDTZ);
+			}
+
+			int rank = 0;
+			if (dtz > 0)
+				rank = dtz + halfmoves <= 99 ? 2 * MaxRank - dtz : MaxRank - (dtz + halfmoves);
+			else if (dtz < 0)
+				rank = -dtz * 2 + halfmoves < 100 ? -2 * MaxRank - dtz : -MaxRank + (-dtz + halfmoves);
+			ranks.push_back(rank);
+		}
+
+		int bestRank = *std::max_element(ranks.begin(), ranks.end());
+
+		// Drawing moves all rank 0 and are left for the search to choose between
+		size_t kept = 0;
+		for (size_t i = 0; i < moves.size(); i++)
+			if (ranks[i] == bestRank)
+				moves[kept++] = moves[i];
+		moves.resize(kept);
+
+		return true;
+	}
+
+}
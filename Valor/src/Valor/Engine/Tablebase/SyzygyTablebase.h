@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Chess/Move.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Valor::Engine {
+
+	// Result from the side to move's point of view. Cursed wins and blessed losses are draws
+	// under the fifty-move rule.
+	enum class WDLScore : int8_t
+	{
+		Loss = -2,
+		BlessedLoss = -1,
+		Draw = 0,
+		CursedWin = 1,
+		Win = 2
+	};
+
+	// Probes Syzygy WDL (.rtbw) and DTZ (.rtbz) tablebases. `Load` looks for the files and checks
+	// a few positions with known results; each file is memory mapped the first time a position
+	// needs it. Probing is thread safe, loading is not.
+	class SyzygyTablebase
+	{
+	public:
+		SyzygyTablebase();
+		~SyzygyTablebase();
+
+		// Registers the tables found in `paths`, a list of directories separated by ':' (';' on Windows).
+		// Replaces any tables loaded before, and returns the number of WDL tables found, or 0 if the tables
+		// are refused for giving wrong results.
+		int Load(const std::string& paths);
+		void Clear();
+
+		// Most pieces, kings included, in any loaded table
+		int GetMaxPieces() const { return m_MaxPieces; }
+
+		// Empty if the position has castling rights or its table is missing. Ignores the fifty-move counter.
+		std::optional<WDLScore> ProbeWDL(const Board& board) const;
+
+		// Plies until the fifty-move counter is reset by a capture or pawn move on the way to the best result,
+		// positive when winning, negative when losing and 0 for draws
+		std::optional<int> ProbeDTZ(const Board& board) const;
+
+		// Keeps only the moves reaching the best result the fifty-move rule allows, preferring the fastest
+		// progress when winning and the longest resistance when losing. Returns false, leaving `moves`
+		// alone, if any of them can't be probed.
+		bool FilterRootMoves(const Board& board, std::vector<Move>& moves) const;
+	public:
+		// Defined with the decoder
+		struct Table;
+	private:
+		struct TablePair
+		{
+			Table* WDL = nullptr;
+			Table* DTZ = nullptr;
+		};
+
+		void AddTable(const std::vector<std::string>& directories, const std::string& code);
+		const TablePair* FindTables(const Board& board) const;
+
+		// Probes positions with known results, refusing tables the decoder reads wrong
+		bool CheckReferencePositions() const;
+
+		std::optional<WDLScore> SearchWDL(const Board& board, bool includePawnMoves, bool& isZeroingBest) const;
+		std::optional<int> SearchDTZ(const Board& board) const;
+
+		// Value stored for `board`, empty if its table is missing or, for DTZ, only stores the other side to move
+		std::optional<int> ReadTable(const Board& board, bool isDTZ, WDLScore wdl, bool* isOtherSide = nullptr) const;
+	private:
+		std::vector<std::unique_ptr<Table>> m_Tables;
+		std::unordered_map<uint64_t, TablePair> m_TablesByMaterial;
+		int m_MaxPieces = 0;
+	};
+
+}
@@ -0,0 +1,154 @@
+#include "vlpch.h"
+#include "Valor/Engine/TranspositionTable.h"
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Core/MappedFile.h"
+#include "Valor/Core/ZobristHasher.h"
+#include "Valor/Engine/Evaluator/Evaluator.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace Valor::Engine {
+
+	// File layout: a header followed by fixed size records in native byte order. The magic number
+	// doubles as a byte order check.
+	constexpr uint32_t TTFileMagic = 0x54544c56; // "VLTT"
+	constexpr uint32_t TTFileVersion = 1;
+
+	struct TTFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t KeyCheck; // Key of the start position, which changes with the Zobrist keys
+		uint64_t EntryCount;
+	};
+
+	struct TTFileRecord
+	{
+		uint64_t Hash;
+		int32_t Score;
+		uint8_t Depth;
+		uint8_t Flag;
+		uint8_t Source;
+		uint8_t Target;
+		uint8_t Piece;
+		uint8_t MoveFlags;
+		uint8_t Promotion;
+		uint8_t Padding[5];
+	};
+
+	static_assert(sizeof(TTFileHeader) == 24);
+	static_assert(sizeof(TTFileRecord) == 24);
+
+	static bool IsValidPieceType(uint8_t piece, bool isPromotion)
+	{
+		if (piece == (uint8_t)PieceType::None)
+			return true;
+		return isPromotion ? piece >= (uint8_t)PieceType::Knight && piece <= (uint8_t)PieceType::Queen
+			: piece <= (uint8_t)PieceType::King;
+	}
+
+	// Every field is checked before it's cast into the table, since the file may be damaged or not ours
+	static bool IsValidRecord(const TTFileRecord& record)
+	{
+		constexpr uint8_t knownMoveFlags = MoveFlags::Capture | MoveFlags::Castling | MoveFlags::Promotion
+			| MoveFlags::EnPassant | MoveFlags::Check | MoveFlags::Checkmate;
+
+		bool isNoMove = record.Source == Tile::None.TileIndex && record.Target == Tile::None.TileIndex;
+		bool isMove = Tile(record.Source).IsValid() && Tile(record.Target).IsValid();
+
+		return record.Hash != 0
+			&& record.Score >= -MateScore && record.Score <= MateScore
+			&& record.Flag <= (uint8_t)TTEntryFlag::UpperBound
+			&& (isNoMove || isMove)
+			&& IsValidPieceType(record.Piece, false)
+			&& IsValidPieceType(record.Promotion, true)
+			&& (record.MoveFlags & ~knownMoveFlags) == 0;
+	}
+
+	int TranspositionTable::Save(const std::string& path, int minDepth) const
+	{
+		std::vector<TTFileRecord> records;
+		for (const TTEntry& entry : m_Entries)
+		{
+			if (entry.Hash == 0 || entry.Depth < minDepth)
+				continue;
+
+			TTFileRecord record = {};
+			record.Hash = entry.Hash;
+			record.Score = entry.Score;
+			record.Depth = (uint8_t)entry.Depth;
+			record.Flag = (uint8_t)entry.Flag;
+			record.Source = entry.BestMove.Source;
+			record.Target = entry.BestMove.Target;
+			record.Piece = (uint8_t)entry.BestMove.Piece;
+			record.MoveFlags = entry.BestMove.Flags;
+			record.Promotion = (uint8_t)entry.BestMove.Promotion;
+			records.push_back(record);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "Could not write transposition table to " << path << std::endl;
+			return -1;
+		}
+
+		TTFileHeader header = { TTFileMagic, TTFileVersion, ZobristHasher::Hash(Board()), records.size() };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TTFileRecord));
+		return file ? (int)records.size() : -1;
+	}
+
+	int TranspositionTable::Load(const std::string& path)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+			return -1;
+
+		TTFileHeader header;
+		if (file.GetSize() < sizeof(header))
+			return -1;
+		std::memcpy(&header, file.GetData(), sizeof(header));
+
+		// The count is bounded by the file size first, so a crafted count can't overflow the size check
+		size_t recordBytes = file.GetSize() - sizeof(header);
+		if (header.Magic != TTFileMagic || header.Version != TTFileVersion
+			|| header.EntryCount > recordBytes / sizeof(TTFileRecord) || recordBytes != header.EntryCount * sizeof(TTFileRecord))
+		{
+			std::cerr << path << " is not a transposition table file of this version" << std::endl;
+			return -1;
+		}
+
+		if (header.KeyCheck != ZobristHasher::Hash(Board()))
+		{
+			std::cerr << path << " was written with different Zobrist keys" << std::endl;
+			return -1;
+		}
+
+		// Records of the file can replace each other, so stored slots are counted rather than stores
+		const uint8_t* records = file.GetData() + sizeof(header);
+		std::vector<bool> isStored(m_Entries.size(), false);
+		for (uint64_t i = 0; i < header.EntryCount; i++)
+		{
+			TTFileRecord record;
+			std::memcpy(&record, records + i * sizeof(TTFileRecord), sizeof(record));
+
+			if (!IsValidRecord(record))
+				continue;
+
+			size_t index = record.Hash & (m_Entries.size() - 1);
+			TTEntry& entry = m_Entries[index];
+			if (entry.Hash != 0 && entry.Depth > record.Depth)
+				continue;
+
+			Move bestMove(record.Source, record.Target, (PieceType)record.Piece, record.MoveFlags, (PieceType)record.Promotion);
+			entry = { record.Hash, record.Score, bestMove, record.Depth, (TTEntryFlag)record.Flag };
+			isStored[index] = true;
+		}
+
+		return (int)std::count(isStored.begin(), isStored.end(), true);
+	}
+
+}
@@ -3,7 +3,9 @@
 #include "Valor/Chess/Move.h"
 
 #include <vector>
-#include <cstring> // for memset
+#include <algorithm>
+#include <bit>
+#include <string>
 
 namespace Valor::Engine {
 
@@ -16,36 +18,54 @@ namespace Valor::Engine {
 
 	struct TTEntry
 	{
-		uint64_t Hash;
-		int Score;
+		uint64_t Hash = 0;
+		int Score = 0;
 		Move BestMove;
-		int Depth;
-		TTEntryFlag Flag;
+		int Depth = 0;
+		TTEntryFlag Flag = TTEntryFlag::Exact;
 	};
 
-	constexpr size_t TTSize = 1 << 20; // 1M entries
+	constexpr size_t TTSize = 1 << 20; // 1M entries by default
 
 	class TranspositionTable
 	{
 	public:
-		TranspositionTable() : m_Entries(TTSize) {} // Allocate on heap
+		explicit TranspositionTable(size_t entryCount = TTSize) { Resize(entryCount); }
+
+		// Rounded down to a power of two. Clears the table.
+		void Resize(size_t entryCount)
+		{
+			m_Entries.assign(std::bit_floor(std::max<size_t>(entryCount, 1)), TTEntry{});
+		}
+
+		size_t GetSize() const { return m_Entries.size(); }
 
 		void Store(uint64_t hash, int score, Move bestMove, int depth, TTEntryFlag flag)
 		{
-			m_Entries[hash % TTSize] = { hash, score, bestMove, depth, flag };
+			m_Entries[hash & (m_Entries.size() - 1)] = { hash, score, bestMove, depth, flag };
 		}
 
 		TTEntry* Lookup(uint64_t hash)
 		{
-			TTEntry& entry = m_Entries[hash % TTSize];
+			TTEntry& entry = m_Entries[hash & (m_Entries.size() - 1)];
 			return entry.Hash == hash ? &entry : nullptr;
 		}
 
 		void Clear()
 		{
-			memset(m_Entries.data(), 0, TTSize * sizeof(TTEntry));
+			std::fill(m_Entries.begin(), m_Entries.end(), TTEntry{});
 		}
 
+		// Writes the entries searched at least `minDepth` deep to a versioned file, so a later process
+		// can start from them. Returns the number of entries written, or -1 if the file can't be written.
+		int Save(const std::string& path, int minDepth = 0) const;
+
+		// Memory maps a file written by `Save` and merges its entries in, keeping the deeper entry where
+		// two share a slot. Rejects files of another version or written with other Zobrist keys.
+		// Records with out of range fields are skipped. Returns the number of entries stored, or -1 if the
+		// file is missing or incompatible.
+		int Load(const std::string& path);
+
 	private:
 		std::vector<TTEntry> m_Entries; // Heap allocation
 	};
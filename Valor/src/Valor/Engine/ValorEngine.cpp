@@ -9,27 +9,186 @@ namespace Valor::Engine {
 	{
 	}
 
+	ValorEngine::~ValorEngine()
+	{
+		Stop();
+	}
+
 	Move ValorEngine::SearchBestMove(const Board& board, int depth)
 	{
-		Minimax minimax;
-		std::unique_ptr<Evaluator> evaluator = std::make_unique<PositionalEvaluator>();
+		SearchLimits limits;
+		limits.Depth = depth;
+		return Search(board, limits).BestMove;
+	}
+
+	Move ValorEngine::SearchBestMove(const Board& board, std::chrono::milliseconds timeLimit, int maxDepth)
+	{
+		SearchLimits limits;
+		limits.Depth = maxDepth;
+		limits.Time = timeLimit;
+		return Search(board, limits).BestMove;
+	}
+
+	SearchResult ValorEngine::Search(const Board& board, const SearchLimits& limits, const SearchInfoCallback& onInfo)
+	{
+		Stop();
+
+		ResetControl(limits);
+		m_SearchControl.SetStopToken({});
+		return RunSearch(board, m_GameHistory, limits, onInfo);
+	}
+
+	std::future<SearchResult> ValorEngine::SearchAsync(const Board& board, const SearchLimits& limits, std::stop_token stopToken, SearchInfoCallback onInfo)
+	{
+		// The search state is shared, so only one search may run at a time
+		Stop();
+		return StartSearchThread(board, limits, std::move(stopToken), std::move(onInfo));
+	}
 
-		return minimax.FindBestMove(const_cast<Board&>(board), depth, evaluator.get());
+	void ValorEngine::Stop()
+	{
+		StopPondering();
+		StopSearchThread();
 	}
 
-	int ValorEngine::AlphaBeta(const Board& board, int alpha, int beta, int depth, bool isMaximizing)
+	void ValorEngine::StartPondering(const Board& board)
 	{
-		return 0;
+		Stop();
+		m_PonderSearch = StartSearchThread(board, SearchLimits(), {}, {});
+		m_PonderThreadNumber = m_SearchThreadNumber;
 	}
 
-	void ValorEngine::UpdateKillerMoves(Move move, int depth)
+	Move ValorEngine::PonderHit(std::chrono::milliseconds timeLimit)
 	{
+		if (!IsPondering())
+			return Move();
+
+		// The time already spent pondering is free; the clock only starts now
+		SetTimeLimit(timeLimit);
+		return m_PonderSearch.get().BestMove;
+	}
+
+	void ValorEngine::StopPondering()
+	{
+		if (IsPondering())
+			StopSearchThread();
+
+		m_PonderSearch = {};
+	}
+
+	std::future<SearchResult> ValorEngine::StartSearchThread(const Board& board, const SearchLimits& limits, std::stop_token stopToken, SearchInfoCallback onInfo)
+	{
+		// Set before the thread starts, so a deadline moved by `PonderHit` right away isn't overwritten
+		ResetControl(limits);
+
+		std::promise<SearchResult> promise;
+		std::future<SearchResult> future = promise.get_future();
+
+		m_SearchThreadNumber++;
+		m_SearchThread = std::jthread([this, board, history = m_GameHistory, limits, stopToken = std::move(stopToken), onInfo = std::move(onInfo),
+			promise = std::move(promise)](std::stop_token ownToken) mutable
+		{
+			// Either the caller's token or `Stop` ends the search
+			std::stop_source stopSource;
+			std::stop_callback onCallerStop(stopToken, [&stopSource]() { stopSource.request_stop(); });
+			std::stop_callback onOwnStop(ownToken, [&stopSource]() { stopSource.request_stop(); });
+
+			m_SearchControl.SetStopToken(stopSource.get_token());
+			promise.set_value(RunSearch(board, history, limits, onInfo));
+		});
 
+		return future;
+	}
+
+	void ValorEngine::StopSearchThread()
+	{
+		if (!m_SearchThread.joinable())
+			return;
+
+		m_SearchThread.request_stop();
+		m_SearchThread.join();
+	}
+
+	bool ValorEngine::LoadNetwork(const std::string& path)
+	{
+		if (!m_Network.Load(path))
+			return false;
+
+		// Cached evaluations and accumulators came from the previous evaluator
+		m_SearchState.EvalCache.Clear();
+		m_NNUEEvaluator.Reset();
+		return true;
+	}
+
+	void ValorEngine::ClearSearchState()
+	{
+		m_SearchState.KillerMoves.Clear();
+		m_SearchState.HistoryHeuristics.Clear();
+		m_SearchState.TranspositionTable.Clear();
+		m_SearchState.PawnTable.Clear();
+		m_SearchState.EvalCache.Clear();
+		m_PrincipalVariations.clear();
+	}
+
+	SearchResult ValorEngine::RunSearch(const Board& board, std::span<const uint64_t> history, const SearchLimits& limits, const SearchInfoCallback& onInfo)
+	{
+		// A book move might not be among the moves the search is restricted to
+		std::optional<Move> bookMove = limits.SearchMoves.empty() ? m_OpeningBook.Probe(board, m_BookSelection) : std::nullopt;
+		if (bookMove)
+		{
+			m_PrincipalVariations.clear();
+
+			SearchResult result;
+			result.BestMove = *bookMove;
+			result.IsBookMove = true;
+			return result;
+		}
+
+		// The only point the evaluator is chosen at runtime; the search below it is compiled for each one
+		if (m_Network.IsLoaded())
+			return RunSearch(board, history, limits, onInfo, m_NNUEEvaluator);
+		return RunSearch(board, history, limits, onInfo, m_PositionalEvaluator);
+	}
+
+	template<SearchEvaluator TEvaluator>
+	SearchResult ValorEngine::RunSearch(const Board& board, std::span<const uint64_t> history, const SearchLimits& limits, const SearchInfoCallback& onInfo, TEvaluator& evaluator)
+	{
+		Minimax<TEvaluator> minimax(m_SearchState, m_SearchOptions, &m_SearchControl);
+		minimax.SetGameHistory(history);
+		minimax.SetTablebase(m_Tablebase.GetMaxPieces() > 0 ? &m_Tablebase : nullptr);
+
+		SearchResult result;
+		result.BestMove = minimax.FindBestMove(board, limits, evaluator, onInfo);
+		result.Nodes = minimax.GetNodes();
+		result.Lines = minimax.GetLines();
+		result.Stats = minimax.GetStats();
+		m_SearchStats += result.Stats;
+
+		m_PrincipalVariations = minimax.GetPrincipalVariations();
+		if (!m_PrincipalVariations.empty())
+		{
+			result.Score = m_PrincipalVariations.back().Score;
+			result.Depth = m_PrincipalVariations.back().Depth;
+		}
+		result.PonderMove = GetPonderMove();
+
+		return result;
+	}
+
+	void ValorEngine::ResetControl(const SearchLimits& limits)
+	{
+		if (limits.Time.count() > 0)
+			m_SearchControl.SetDeadline(SearchClock::now() + limits.Time);
+		else
+			m_SearchControl.ClearDeadline();
 	}
 
-	void ValorEngine::UpdateHistoryHeuristics(Move move, int depth)
+	Move ValorEngine::GetPonderMove() const
 	{
+		if (m_PrincipalVariations.empty() || m_PrincipalVariations.back().Moves.size() < 2)
+			return Move();
 
+		return m_PrincipalVariations.back().Moves[1];
 	}
 
 }
@@ -1,25 +1,151 @@
 #pragma once
 
 #include "Valor/Chess/Board.h"
-#include "Valor/Engine/TranspositionTable.h"
+#include "Valor/Engine/Book/PolyglotBook.h"
+#include "Valor/Engine/Evaluator/Evaluator.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUEEvaluator.h"
+#include "Valor/Engine/Evaluator/NNUE/NNUENetwork.h"
+#include "Valor/Engine/PrincipalVariation.h"
+#include "Valor/Engine/SearchControl.h"
+#include "Valor/Engine/SearchLimits.h"
+#include "Valor/Engine/SearchOptions.h"
 #include "Valor/Engine/SearchState.h"
+#include "Valor/Engine/SearchStats.h"
+#include "Valor/Engine/Tablebase/SyzygyTablebase.h"
+
+#include <chrono>
+#include <future>
+#include <span>
+#include <stop_token>
+#include <thread>
 
 namespace Valor::Engine {
 
+	struct SearchResult
+	{
+		Move BestMove;
+		Move PonderMove; // Expected reply, invalid if the PV is too short
+		int Score = 0;
+		int Depth = 0;   // Last completed depth
+		uint64_t Nodes = 0;
+		bool IsBookMove = false; // Taken from the opening book without searching
+
+		// Best lines of the last completed depth, best first; more than one with `SearchOptions::MultiPV`
+		std::vector<PrincipalVariation> Lines;
+
+		SearchStats Stats;
+	};
+
 	class ValorEngine
 	{
 	public:
 		ValorEngine();
+		~ValorEngine();
 		
 		Move SearchBestMove(const Board& board, int depth);
+		Move SearchBestMove(const Board& board, std::chrono::milliseconds timeLimit, int maxDepth = MaxPly - 1);
+
+		// Blocking search on the calling thread
+		SearchResult Search(const Board& board, const SearchLimits& limits, const SearchInfoCallback& onInfo = {});
+
+		// Searches on a background thread. Requesting a stop on `stopToken` (or calling `Stop`) ends the search
+		// within a few thousand nodes, and the future then holds the best move found so far. `onInfo` is called
+		// from the search thread. Only one search runs at a time; starting another stops the previous one.
+		std::future<SearchResult> SearchAsync(const Board& board, const SearchLimits& limits, std::stop_token stopToken = {}, SearchInfoCallback onInfo = {});
+		void Stop();
+
+		// Gives the running search `timeLimit` from now, replacing its time limit or lack of one
+		void SetTimeLimit(std::chrono::milliseconds timeLimit) { m_SearchControl.SetDeadline(SearchClock::now() + timeLimit); }
+
+		// Pondering: search `board`, the position after the expected reply, on a background thread until
+		// the opponent moves. On a hit the search continues with `timeLimit` from now; on a miss it is
+		// stopped, keeping what it added to the transposition table.
+		void StartPondering(const Board& board);
+		Move PonderHit(std::chrono::milliseconds timeLimit);
+		void StopPondering();
+		bool IsPondering() const { return m_PonderSearch.valid() && m_PonderThreadNumber == m_SearchThreadNumber && m_SearchThread.joinable(); }
+
+		// Zobrist keys of the positions played before the next searched one, oldest first, so the search
+		// can see repetitions of them. Kept for every later search until set again.
+		void SetGameHistory(std::span<const uint64_t> positionKeys) { m_GameHistory.assign(positionKeys.begin(), positionKeys.end()); }
+
+		// Syzygy tablebase directories, separated by ':' (';' on Windows). Returns the number of tables found.
+		// Call it only while no search runs.
+		int LoadTablebases(const std::string& paths) { return m_Tablebase.Load(paths); }
+
+		// Polyglot book consulted before every search; positions found in it are answered without searching.
+		// Call it only while no search runs.
+		bool LoadOpeningBook(const std::string& path) { return m_OpeningBook.Open(path); }
+		void SetBookSelection(BookSelection selection) { m_BookSelection = selection; }
+
+		// Persistent analysis cache: saves the transposition table entries searched at least `minDepth` deep,
+		// or loads them back so repeated analysis starts warm. Both return the number of entries, or -1 on
+		// failure, and must only be called while no search runs.
+		int SaveTranspositionTable(const std::string& path, int minDepth = 0) const { return m_SearchState.TranspositionTable.Save(path, minDepth); }
+		int LoadTranspositionTable(const std::string& path) { return m_SearchState.TranspositionTable.Load(path); }
+
+		// NNUE network used instead of the hand-written evaluation from the next search on. Returns false,
+		// keeping the current one, if the file isn't a network this engine can run. Call it only while no search runs.
+		bool LoadNetwork(const std::string& path);
+		bool IsNetworkLoaded() const { return m_Network.IsLoaded(); }
+
+		// Entries in the static evaluation cache, rounded down to a power of two. Call it only while no search runs.
+		void SetEvalCacheSize(size_t entryCount) { m_SearchState.EvalCache.Resize(entryCount); }
+
+		// Entries in the transposition table, rounded down to a power of two; clears it. Call it only while no search runs.
+		void SetTranspositionTableSize(size_t entryCount) { m_SearchState.TranspositionTable.Resize(entryCount); }
+
+		// Forgets everything earlier searches learned, for a new game. Call it only while no search runs.
+		void ClearSearchState();
+
+		// Takes effect from the next search
+		void SetSearchOptions(const SearchOptions& options) { m_SearchOptions = options; }
+		const SearchOptions& GetSearchOptions() const { return m_SearchOptions; }
+
+		// Principal variations of the last finished search, one per completed depth. The search thread rewrites
+		// them, so read them only while no search runs.
+		const std::vector<PrincipalVariation>& GetPrincipalVariations() const { return m_PrincipalVariations; }
+
+		// Expected reply to the last best move, invalid if the PV is too short. Call it only while no search runs.
+		Move GetPonderMove() const;
+
+		// Statistics of every search since the last reset, pondering included. Read them only while no search runs.
+		const SearchStats& GetSearchStats() const { return m_SearchStats; }
+		void ResetSearchStats() { m_SearchStats = {}; }
+	private:
+		SearchResult RunSearch(const Board& board, std::span<const uint64_t> history, const SearchLimits& limits, const SearchInfoCallback& onInfo);
+		template<SearchEvaluator TEvaluator>
+		SearchResult RunSearch(const Board& board, std::span<const uint64_t> history, const SearchLimits& limits, const SearchInfoCallback& onInfo, TEvaluator& evaluator);
+		void ResetControl(const SearchLimits& limits);
+
+		// The background search thread behind both `SearchAsync` and pondering
+		std::future<SearchResult> StartSearchThread(const Board& board, const SearchLimits& limits, std::stop_token stopToken, SearchInfoCallback onInfo);
+		void StopSearchThread();
 	private:
-		int AlphaBeta(const Board& board, int alpha, int beta, int depth, bool isMaximizing);
-		void UpdateKillerMoves(Move move, int depth);
-		void UpdateHistoryHeuristics(Move move, int depth);
+		SearchOptions m_SearchOptions;
+
+		// Transposition table, killers and history persist between searches
+		SearchState m_SearchState;
+
+		std::vector<PrincipalVariation> m_PrincipalVariations;
+		std::vector<uint64_t> m_GameHistory;
+		SearchStats m_SearchStats;
+		SyzygyTablebase m_Tablebase;
+		PolyglotBook m_OpeningBook;
+		NNUENetwork m_Network;
+
+		// Kept between searches, so starting one allocates nothing. The NNUE one is used once a network is loaded.
+		PositionalEvaluator m_PositionalEvaluator{ &m_SearchState.PawnTable };
+		NNUEEvaluator m_NNUEEvaluator{ m_Network };
+		BookSelection m_BookSelection = BookSelection::Weighted;
+
+		SearchControl m_SearchControl;
+		std::jthread m_SearchThread;
+		uint64_t m_SearchThreadNumber = 0; // Counts the threads started, telling the running one apart
 
-		TranspositionTable m_TranspositionTable;
-		HistoryHeuristics m_HistoryHeuristics;
-		KillerMoves m_KillerMoves;
+		// Only touched by the pondering functions. It belongs to the running thread only while its number matches.
+		std::future<SearchResult> m_PonderSearch;
+		uint64_t m_PonderThreadNumber = 0;
 	};
 
 }
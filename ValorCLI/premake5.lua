@@ -42,3 +42,8 @@ project "ValorCLI"
         defines "VL_RELEASE"
         runtime "Release"
         optimize "on"
+
+    filter "configurations:Dist"
+        defines "VL_DIST"
+        runtime "Release"
+        optimize "on"
@@ -1,30 +1,65 @@
+#include "UCIProtocol.h"
+
 #include "Valor/Chess/Game.h"
 #include "Valor/Engine/ValorEngine.h"
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
 static void ClearConsole()
 {
 	system("cls");
 }
+
+static bool IsInputInteractive()
+{
+	return _isatty(_fileno(stdin));
+}
 #else
 #include <cstdlib>
+#include <unistd.h>
 static void ClearConsole()
 {
 	system("clear");
 }
+
+static bool IsInputInteractive()
+{
+	return isatty(fileno(stdin));
+}
 #endif
 
-int main()
+constexpr std::chrono::milliseconds AIThinkTime(2000);
+
+// Promotion piece of a move as MakeMove applies it: a pawn reaching the last rank without one becomes a queen.
+// Only meaningful between moves on the same squares, since non-promotions also give a queen.
+static Valor::PieceType GetPromotion(Valor::Move move)
+{
+	return move.Promotion == Valor::PieceType::None ? Valor::PieceType::Queen : move.Promotion;
+}
+
+int main(int argc, char** argv)
 {
+	// Chess GUIs and match runners talk UCI over a pipe; a person at a terminal gets a game
+	if ((argc > 1 && std::string(argv[1]) == "uci") || !IsInputInteractive())
+	{
+		Valor::CLI::UCIProtocol().Run();
+		return 0;
+	}
+
 	// Player vs. AI
 	Valor::Game game;
 	Valor::Engine::ValorEngine engine;
 
+	// Reply the engine expects, and is searching ahead on while the player thinks
+	Valor::Move ponderMove;
+	bool isPonderHit = false;
+
 	// Print initial board before any moves
 	ClearConsole();
 	std::cout << game.GetBoard() << std::endl;
@@ -40,6 +75,47 @@ int main()
 			if (move == "exit")
 				break;
 
+			if (move == "stats")
+			{
+				// The ponder search still writes to the stats
+				engine.StopPondering();
+				std::cout << engine.GetSearchStats() << std::endl;
+				continue;
+			}
+
+			if (move == "syzygy")
+			{
+				std::string paths;
+				std::cin >> paths;
+
+				// Tables can't be swapped under a running search
+				engine.StopPondering();
+				std::cout << "Found " << engine.LoadTablebases(paths) << " tablebases" << std::endl;
+				continue;
+			}
+
+			if (move == "nnue")
+			{
+				std::string path;
+				std::cin >> path;
+
+				engine.StopPondering();
+				if (engine.LoadNetwork(path))
+					std::cout << "Network loaded" << std::endl;
+				continue;
+			}
+
+			if (move == "book")
+			{
+				std::string path;
+				std::cin >> path;
+
+				engine.StopPondering();
+				if (engine.LoadOpeningBook(path))
+					std::cout << "Opening book loaded" << std::endl;
+				continue;
+			}
+
 			Valor::Move playerMove = Valor::Move::FromAlgebraic(move);
 			if (!game.GetBoard().IsLegalMove(playerMove))
 			{
@@ -47,6 +123,13 @@ int main()
 				continue;
 			}
 
+			// Keep the ponder search if the player played the expected move, otherwise stop it. Move equality only
+			// looks at the squares, so an underpromotion on the pondered squares has to be told apart here.
+			isPonderHit = engine.IsPondering() && playerMove == ponderMove
+				&& GetPromotion(playerMove) == GetPromotion(ponderMove);
+			if (!isPonderHit)
+				engine.StopPondering();
+
 			Valor::MoveInfo moveInfo = game.GetBoard().ParseMove(playerMove.Source, playerMove.Target);
 			game.MakeMove(playerMove);
 
@@ -60,14 +143,27 @@ int main()
 			// AI turn
 			std::cout << "AI is thinking..." << std::endl;
 
-			Valor::Move bestMove = engine.SearchBestMove(game.GetBoard(), 6);
+			if (!isPonderHit)
+				engine.SetGameHistory(game.GetHashHistory());
+
+			Valor::Move bestMove = isPonderHit ? engine.PonderHit(AIThinkTime) : engine.SearchBestMove(game.GetBoard(), AIThinkTime);
 			Valor::MoveInfo moveInfo = game.GetBoard().ParseMove(bestMove.Source, bestMove.Target);
 			game.MakeMove(bestMove);
 
 			// Print AI move and board after AI's turn
 			ClearConsole();
 			std::cout << game.GetBoard() << '\n';
-			std::cout << "AI played: " << moveInfo.ToAlgebraic() << '\n' << std::endl;
+			std::cout << "AI played: " << moveInfo.ToAlgebraic() << (isPonderHit ? " (ponder hit)" : "") << '\n' << std::endl;
+
+			// Think about the expected reply while waiting for the player
+			ponderMove = engine.GetPonderMove();
+			if (ponderMove.IsValid() && !game.IsGameOver() && game.GetBoard().IsLegalMove(ponderMove))
+			{
+				Valor::Game ponderGame = game;
+				ponderGame.MakeMove(ponderMove);
+				engine.SetGameHistory(ponderGame.GetHashHistory());
+				engine.StartPondering(ponderGame.GetBoard());
+			}
 		}
 	}
 }
@@ -0,0 +1,472 @@
+#include "UCIProtocol.h"
+
+#include "Valor/Chess/MoveGeneration/MoveGeneratorSimple.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+
+namespace Valor::CLI {
+
+	// Kept back from every time limit, for the delay between the engine sending a move and the clock stopping
+	constexpr int64_t MoveOverhead = 30;
+
+	// Moves a clock without `movestogo` is shared between, and the most a `movestogo` is trusted for
+	constexpr int64_t DefaultMovesToGo = 30;
+	constexpr int64_t MaxMovesToGo = 50;
+
+	constexpr int64_t MaxHashMegabytes = 1 << 16;
+	constexpr int64_t DefaultHashMegabytes = (int64_t)(Engine::TTSize * sizeof(Engine::TTEntry)) >> 20;
+
+	static std::vector<std::string_view> SplitTokens(std::string_view text)
+	{
+		std::vector<std::string_view> tokens;
+		while (true)
+		{
+			size_t begin = text.find_first_not_of(" \t\r");
+			if (begin == std::string_view::npos)
+				return tokens;
+
+			text.remove_prefix(begin);
+			size_t end = std::min(text.find_first_of(" \t\r"), text.size());
+			tokens.push_back(text.substr(0, end));
+			text.remove_prefix(end);
+		}
+	}
+
+	// The text from the first of `tokens` to the end of the last, as it was in the command
+	static std::string_view JoinTokens(std::span<const std::string_view> tokens)
+	{
+		if (tokens.empty())
+			return {};
+		return { tokens.front().data(), (size_t)(tokens.back().data() + tokens.back().size() - tokens.front().data()) };
+	}
+
+	static bool ParseInteger(std::string_view text, int64_t& value)
+	{
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		return error == std::errc() && end == text.data() + text.size();
+	}
+
+	static bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+			[](char x, char y) { return std::tolower((unsigned char)x) == std::tolower((unsigned char)y); });
+	}
+
+	// The legal move written as `text` in coordinate notation, or an invalid move
+	static Move ParseMove(const Board& board, std::string_view text)
+	{
+		for (const Move& move : MoveGeneratorSimple::GenerateLegalMoves(board))
+		{
+			if (move.ToAlgebraic() == text)
+				return move;
+		}
+		return Move();
+	}
+
+	// Time for this move: an even share of the clock plus most of the increment, never all of what's left
+	static std::chrono::milliseconds AllocateTime(int64_t remaining, int64_t increment, int64_t movesToGo)
+	{
+		int64_t moves = movesToGo > 0 ? std::min(movesToGo, MaxMovesToGo) : DefaultMovesToGo;
+		int64_t time = remaining / moves + increment * 3 / 4;
+		return std::chrono::milliseconds(std::clamp<int64_t>(time, 1, std::max<int64_t>(remaining - MoveOverhead, 1)));
+	}
+
+	void UCIProtocol::Run()
+	{
+		// Reads ahead of the command loop, so a `stop` is seen while the loop is busy
+		std::jthread input([this]()
+		{
+			std::string line;
+			while (std::getline(std::cin, line))
+			{
+				bool isQuit = SplitTokens(line) == std::vector<std::string_view>{ "quit" };
+				{
+					std::lock_guard lock(m_EventMutex);
+					m_Commands.push_back(std::move(line));
+				}
+				m_EventSignal.notify_one();
+
+				if (isQuit)
+					return;
+			}
+
+			std::lock_guard lock(m_EventMutex);
+			m_Commands.push_back("quit");
+			m_EventSignal.notify_one();
+		});
+
+		while (true)
+		{
+			std::unique_lock lock(m_EventMutex);
+			m_EventSignal.wait(lock, [this]() { return m_FinishedSearch || !m_Commands.empty(); });
+
+			if (m_FinishedSearch)
+			{
+				Engine::SearchResult result = std::move(*m_FinishedSearch);
+				m_FinishedSearch.reset();
+				lock.unlock();
+
+				OnSearchFinished(std::move(result));
+				continue;
+			}
+
+			std::string command = std::move(m_Commands.front());
+			m_Commands.pop_front();
+			lock.unlock();
+
+			if (!HandleCommand(command))
+				break;
+		}
+
+		StopSearch();
+	}
+
+	bool UCIProtocol::HandleCommand(std::string_view command)
+	{
+		std::vector<std::string_view> tokens = SplitTokens(command);
+		if (tokens.empty())
+			return true;
+
+		std::string_view name = tokens.front();
+		std::string_view arguments = JoinTokens(std::span(tokens).subspan(1));
+
+		if (name == "uci")
+			SendIdentity();
+		else if (name == "isready")
+			Send("readyok");
+		else if (name == "ucinewgame")
+		{
+			StopSearch();
+			m_Engine.ClearSearchState();
+		}
+		else if (name == "position")
+		{
+			StopSearch();
+			HandlePosition(arguments);
+		}
+		else if (name == "go")
+			HandleGo(arguments);
+		else if (name == "stop")
+			HandleStop();
+		else if (name == "ponderhit")
+			HandlePonderHit();
+		else if (name == "setoption")
+		{
+			StopSearch();
+			HandleSetOption(arguments);
+		}
+		else if (name == "quit")
+			return false;
+
+		// Anything else is ignored, as the protocol asks
+		return true;
+	}
+
+	void UCIProtocol::SendIdentity()
+	{
+		Send("id name Valor");
+		Send("id author Pixl");
+		Send("option name Hash type spin default " + std::to_string(DefaultHashMegabytes) + " min 1 max " + std::to_string(MaxHashMegabytes));
+		Send("option name Threads type spin default 1 min 1 max 1");
+		Send("option name Ponder type check default false");
+		Send("option name MultiPV type spin default 1 min 1 max 256");
+		Send("option name SyzygyPath type string default <empty>");
+		Send("option name SyzygyProbeLimit type spin default 7 min 0 max 7");
+		Send("uciok");
+	}
+
+	void UCIProtocol::HandlePosition(std::string_view arguments)
+	{
+		std::vector<std::string_view> tokens = SplitTokens(arguments);
+		auto movesToken = std::find(tokens.begin(), tokens.end(), "moves");
+		std::span<const std::string_view> setup(tokens.begin(), movesToken);
+
+		Board board;
+		if (setup.empty() || (setup.front() != "startpos" && setup.front() != "fen"))
+		{
+			Send("info string Expected startpos or fen");
+			return;
+		}
+		if (setup.front() == "fen" && !Board::FromFEN(JoinTokens(setup.subspan(1)), board))
+		{
+			Send("info string Invalid FEN");
+			return;
+		}
+
+		m_Board = board;
+		m_History.clear();
+
+		for (auto it = movesToken == tokens.end() ? movesToken : movesToken + 1; it != tokens.end(); ++it)
+		{
+			Move move = ParseMove(m_Board, *it);
+			if (!move.IsValid())
+			{
+				Send("info string Illegal move " + std::string(*it));
+				return;
+			}
+
+			m_History.push_back(m_Board.GetHash());
+			m_Board.MakeMove(move);
+		}
+	}
+
+	void UCIProtocol::HandleGo(std::string_view arguments)
+	{
+		StopSearch();
+
+		Engine::SearchLimits limits;
+		int64_t time[2] = {}, increment[2] = {}, movesToGo = 0, moveTime = 0;
+		bool hasClock = false;
+		m_IsInfinite = false;
+		m_IsPondering = false;
+
+		std::vector<std::string_view> tokens = SplitTokens(arguments);
+		for (size_t i = 0; i < tokens.size(); i++)
+		{
+			std::string_view token = tokens[i];
+			int64_t value = 0;
+			bool hasValue = i + 1 < tokens.size() && ParseInteger(tokens[i + 1], value);
+
+			if (token == "infinite")
+				m_IsInfinite = true;
+			else if (token == "ponder")
+				m_IsPondering = true;
+			else if (token == "searchmoves")
+			{
+				for (; i + 1 < tokens.size(); i++)
+				{
+					Move move = ParseMove(m_Board, tokens[i + 1]);
+					if (!move.IsValid())
+						break;
+					limits.SearchMoves.push_back(move);
+				}
+			}
+			else if (hasValue)
+			{
+				if (token == "wtime" || token == "btime")
+				{
+					time[token == "btime"] = std::max<int64_t>(value, 0);
+					hasClock = true;
+				}
+				else if (token == "winc" || token == "binc")
+					increment[token == "binc"] = std::max<int64_t>(value, 0);
+				else if (token == "movestogo")
+					movesToGo = value;
+				else if (token == "movetime")
+					moveTime = value;
+				else if (token == "depth")
+					limits.Depth = (int)std::clamp<int64_t>(value, 1, Engine::MaxPly - 1);
+				else if (token == "nodes")
+					limits.Nodes = (uint64_t)std::max<int64_t>(value, 1);
+				else if (token == "mate")
+					limits.Mate = (int)std::max<int64_t>(value, 1);
+				i++;
+			}
+		}
+
+		int side = m_Board.IsWhiteTurn() ? 0 : 1;
+		if (moveTime > 0)
+			limits.Time = std::chrono::milliseconds(std::max<int64_t>(moveTime - MoveOverhead, 1));
+		else if (hasClock && !m_IsInfinite)
+			limits.Time = AllocateTime(time[side], increment[side], movesToGo);
+
+		// The clock only runs once the ponder move is played
+		m_PonderTimeLimit = m_IsPondering ? limits.Time : std::chrono::milliseconds(0);
+		if (m_IsPondering)
+			limits.Time = std::chrono::milliseconds(0);
+
+		{
+			std::lock_guard lock(m_OutputMutex);
+			m_PendingInfo.clear();
+			m_LastInfoTime = {};
+		}
+
+		m_IsSearching = true;
+		m_Engine.SetGameHistory(m_History);
+		std::future<Engine::SearchResult> search = m_Engine.SearchAsync(m_Board, limits, {},
+			[this](const Engine::SearchInfo& info) { OnInfo(info); });
+
+		m_SearchWaiter = std::jthread([this, search = std::move(search)]() mutable
+		{
+			Engine::SearchResult result = search.get();
+			{
+				std::lock_guard lock(m_EventMutex);
+				m_FinishedSearch = std::move(result);
+			}
+			m_EventSignal.notify_one();
+		});
+	}
+
+	void UCIProtocol::HandleSetOption(std::string_view arguments)
+	{
+		std::vector<std::string_view> tokens = SplitTokens(arguments);
+		auto nameToken = std::find(tokens.begin(), tokens.end(), "name");
+		auto valueToken = std::find(tokens.begin(), tokens.end(), "value");
+		if (nameToken == tokens.end() || nameToken > valueToken)
+			return;
+
+		std::string_view name = JoinTokens(std::span<const std::string_view>(nameToken + 1, valueToken));
+		std::string_view value = valueToken == tokens.end() ? std::string_view() : JoinTokens(std::span<const std::string_view>(valueToken + 1, tokens.end()));
+
+		int64_t number = 0;
+		bool isNumber = ParseInteger(value, number);
+
+		if (EqualsIgnoreCase(name, "Hash") && isNumber)
+		{
+			int64_t megabytes = std::clamp<int64_t>(number, 1, MaxHashMegabytes);
+			m_Engine.SetTranspositionTableSize((size_t)(megabytes << 20) / sizeof(Engine::TTEntry));
+		}
+		else if (EqualsIgnoreCase(name, "MultiPV") && isNumber)
+		{
+			Engine::SearchOptions options = m_Engine.GetSearchOptions();
+			options.MultiPV = (int)std::clamp<int64_t>(number, 1, 256);
+			m_Engine.SetSearchOptions(options);
+		}
+		else if (EqualsIgnoreCase(name, "SyzygyProbeLimit") && isNumber)
+		{
+			Engine::SearchOptions options = m_Engine.GetSearchOptions();
+			options.SyzygyProbeLimit = (int)std::clamp<int64_t>(number, 0, 7);
+			m_Engine.SetSearchOptions(options);
+		}
+		else if (EqualsIgnoreCase(name, "SyzygyPath"))
+		{
+			if (!value.empty() && value != "<empty>")
+				Send("info string Found " + std::to_string(m_Engine.LoadTablebases(std::string(value))) + " tablebases");
+		}
+		else if (EqualsIgnoreCase(name, "Threads") || EqualsIgnoreCase(name, "Ponder"))
+		{
+			// The search runs on one thread, and pondering needs nothing set up beforehand
+		}
+		else
+			Send("info string No such option: " + std::string(name));
+	}
+
+	void UCIProtocol::HandleStop()
+	{
+		if (!m_IsSearching)
+			return;
+
+		m_IsInfinite = false;
+		m_IsPondering = false;
+		if (m_HeldResult)
+		{
+			SendBestMove(*m_HeldResult);
+			m_HeldResult.reset();
+			m_IsSearching = false;
+		}
+		else
+		{
+			// The result comes back through the command loop
+			m_Engine.Stop();
+		}
+	}
+
+	void UCIProtocol::HandlePonderHit()
+	{
+		if (!m_IsSearching || !m_IsPondering)
+			return;
+
+		m_IsPondering = false;
+		if (m_HeldResult && !m_IsInfinite)
+		{
+			SendBestMove(*m_HeldResult);
+			m_HeldResult.reset();
+			m_IsSearching = false;
+		}
+		else if (m_PonderTimeLimit.count() > 0)
+			m_Engine.SetTimeLimit(m_PonderTimeLimit);
+	}
+
+	void UCIProtocol::StopSearch()
+	{
+		HandleStop();
+		if (!m_IsSearching)
+			return;
+
+		// Take the result here rather than leave it for the command loop
+		m_SearchWaiter.join();
+
+		std::unique_lock lock(m_EventMutex);
+		Engine::SearchResult result = std::move(*m_FinishedSearch);
+		m_FinishedSearch.reset();
+		lock.unlock();
+
+		OnSearchFinished(std::move(result));
+	}
+
+	void UCIProtocol::OnSearchFinished(Engine::SearchResult result)
+	{
+		if (m_SearchWaiter.joinable())
+			m_SearchWaiter.join();
+
+		if (m_IsInfinite || m_IsPondering)
+		{
+			m_HeldResult = std::move(result);
+			return;
+		}
+
+		SendBestMove(result);
+		m_IsSearching = false;
+	}
+
+	void UCIProtocol::OnInfo(const Engine::SearchInfo& info)
+	{
+		std::string line = "info depth " + std::to_string(info.Depth) + " multipv " + std::to_string(info.MultiPV);
+
+		// Mate scores count plies down from `MateScore`; UCI counts moves, negative when getting mated
+		if (std::abs(info.Score) >= Engine::MateScore - Engine::MaxPly)
+		{
+			int moves = info.Score > 0 ? (Engine::MateScore - info.Score + 1) / 2 : -(Engine::MateScore + info.Score) / 2;
+			line += " score mate " + std::to_string(moves);
+		}
+		else
+			line += " score cp " + std::to_string(info.Score);
+
+		line += " nodes " + std::to_string(info.Nodes) + " nps " + std::to_string(info.NodesPerSecond)
+			+ " time " + std::to_string(info.Time.count()) + " pv";
+		for (const Move& move : info.PrincipalVariation)
+			line += " " + move.ToAlgebraic();
+
+		std::lock_guard lock(m_OutputMutex);
+
+		// All lines of an iteration are printed or kept back together, decided at its first
+		if (info.MultiPV == 1)
+		{
+			Engine::SearchClock::time_point now = Engine::SearchClock::now();
+			m_IsPrintingIteration = now - m_LastInfoTime >= InfoInterval;
+			if (m_IsPrintingIteration)
+				m_LastInfoTime = now;
+			m_PendingInfo.clear();
+		}
+
+		if (m_IsPrintingIteration)
+			std::cout << line << '\n' << std::flush;
+		else
+			m_PendingInfo.push_back(std::move(line));
+	}
+
+	void UCIProtocol::Send(std::string_view line)
+	{
+		std::lock_guard lock(m_OutputMutex);
+		std::cout << line << '\n' << std::flush;
+	}
+
+	void UCIProtocol::SendBestMove(const Engine::SearchResult& result)
+	{
+		std::lock_guard lock(m_OutputMutex);
+
+		// The last iteration is always reported, even when it came too soon after the one before
+		for (const std::string& line : m_PendingInfo)
+			std::cout << line << '\n';
+		m_PendingInfo.clear();
+
+		// No legal moves: mated or stalemated
+		std::string line = "bestmove " + (result.BestMove.IsValid() ? result.BestMove.ToAlgebraic() : "0000");
+		if (result.PonderMove.IsValid())
+			line += " ponder " + result.PonderMove.ToAlgebraic();
+		std::cout << line << '\n' << std::flush;
+	}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Engine/ValorEngine.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Valor::CLI {
+
+	// Universal Chess Interface front end. Input is read on its own thread and the search runs on the engine's,
+	// so commands like `stop` and `isready` are answered while a search runs. A third thread waits for the
+	// search to end and hands the result back to the command loop, which sends the best move.
+	class UCIProtocol
+	{
+	public:
+		// Handles commands from standard input until `quit` or the end of the input
+		void Run();
+	private:
+		// Returns false on `quit`
+		bool HandleCommand(std::string_view command);
+
+		void SendIdentity();
+		void HandlePosition(std::string_view arguments);
+		void HandleGo(std::string_view arguments);
+		void HandleSetOption(std::string_view arguments);
+		void HandleStop();
+		void HandlePonderHit();
+
+		// Ends the running search, if any, and sends its best move before returning
+		void StopSearch();
+		void OnSearchFinished(Engine::SearchResult result);
+
+		// Called from the search thread
+		void OnInfo(const Engine::SearchInfo& info);
+
+		// Writes whole lines to standard output; safe from any thread
+		void Send(std::string_view line);
+		void SendBestMove(const Engine::SearchResult& result);
+	private:
+		// Iterations finishing sooner than this after the last one printed aren't printed, except the last
+		constexpr static std::chrono::milliseconds InfoInterval{ 50 };
+	private:
+		Engine::ValorEngine m_Engine;
+		Board m_Board;
+		std::vector<uint64_t> m_History; // Keys of the positions before `m_Board`
+
+		// Lines read by the input thread and the result of a finished search, both waiting for the command loop
+		std::mutex m_EventMutex;
+		std::condition_variable m_EventSignal;
+		std::deque<std::string> m_Commands;
+		std::optional<Engine::SearchResult> m_FinishedSearch;
+		std::jthread m_SearchWaiter;
+
+		// Owned by the command loop. A search started with `infinite` or `ponder` holds its best move back
+		// until `stop` or `ponderhit`, even if it ends before.
+		bool m_IsSearching = false; // Until the best move is sent
+		bool m_IsInfinite = false;
+		bool m_IsPondering = false;
+		std::chrono::milliseconds m_PonderTimeLimit{ 0 }; // Time for the search once the ponder move is played
+		std::optional<Engine::SearchResult> m_HeldResult;
+
+		// Lines of the last iteration, kept back when printing was throttled
+		std::mutex m_OutputMutex;
+		Engine::SearchClock::time_point m_LastInfoTime;
+		std::vector<std::string> m_PendingInfo;
+		bool m_IsPrintingIteration = false;
+	};
+
+}
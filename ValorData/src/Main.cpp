@@ -0,0 +1,84 @@
+#include "RecordDeduplicator.h"
+#include "RecordPacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void PrintUsage()
+{
+	std::cout << "Usage: ValorData <command> <input> <output> [options]\n"
+		<< "  pack <positions.epd|games.pgn> <records.bin>   Packs FEN/EPD lines or every position of PGN games\n"
+		<< "    --threads <n>    Reading threads (all cores)\n"
+		<< "  dedup <records.bin> <records.bin>              Keeps the first record of each position\n"
+		<< "    --memory <MB>    Records sorted in memory at a time (1024)\n";
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 4)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string command = argv[1];
+	std::string inputPath = argv[2];
+	std::string outputPath = argv[3];
+
+	unsigned threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	size_t memoryBytes = (size_t)1024 << 20;
+
+	for (int i = 4; i + 1 < argc; i += 2)
+	{
+		std::string option = argv[i];
+		std::string value = argv[i + 1];
+
+		if (option == "--threads")
+			threadCount = (unsigned)std::stoul(value);
+		else if (option == "--memory")
+			memoryBytes = std::stoull(value) << 20;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	Clock::time_point start = Clock::now();
+	if (command == "pack")
+	{
+		Valor::Data::RecordPacker packer(threadCount);
+		if (!packer.Pack(inputPath, outputPath))
+			return 1;
+
+		double time = SecondsSince(start);
+		std::cout << "Packed " << packer.GetRecordCount() << " positions in " << time << " s ("
+			<< (size_t)(packer.GetRecordCount() / time) << " positions/s), skipped " << packer.GetSkippedCount() << std::endl;
+	}
+	else if (command == "dedup")
+	{
+		Valor::Data::RecordDeduplicator deduplicator(memoryBytes);
+		if (!deduplicator.Run(inputPath, outputPath))
+			return 1;
+
+		double time = SecondsSince(start);
+		std::cout << "Kept " << deduplicator.GetOutputCount() << " of " << deduplicator.GetInputCount() << " positions in "
+			<< time << " s (" << (size_t)(deduplicator.GetInputCount() / time) << " positions/s, " << deduplicator.GetRunCount()
+			<< " runs), skipped " << deduplicator.GetSkippedCount() << std::endl;
+	}
+	else
+	{
+		PrintUsage();
+		return 1;
+	}
+}
@@ -0,0 +1,167 @@
+#include "RecordDeduplicator.h"
+
+#include "Valor/Chess/Board.h"
+#include "Valor/Core/MappedFile.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <span>
+#include <tuple>
+
+namespace Valor::Data {
+
+	static void RemoveRuns(const std::vector<std::string>& runPaths)
+	{
+		std::error_code error;
+		for (const std::string& path : runPaths)
+			std::filesystem::remove(path, error);
+	}
+
+	bool RecordDeduplicator::Run(const std::string& inputPath, const std::string& outputPath)
+	{
+		PositionRecordFile input;
+		if (!input.Open(inputPath))
+			return false;
+
+		std::span<const PositionRecord> records = input.GetRecords();
+		m_InputCount = records.size();
+		m_OutputCount = m_RunCount = m_SkippedCount = 0;
+
+		size_t runCapacity = std::max<size_t>(m_MemoryBytes / sizeof(KeyedRecord), 1);
+		std::vector<KeyedRecord> run;
+		run.reserve(std::min(runCapacity, records.size()));
+
+		// Every run but the last goes to disk
+		std::vector<std::string> runPaths;
+		Board board;
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			if (!Board::FromPacked(records[i].Position, board))
+			{
+				m_SkippedCount++;
+				continue;
+			}
+
+			run.push_back({ board.GetHash(), i, records[i] });
+			if (run.size() == runCapacity && i + 1 < records.size())
+			{
+				runPaths.push_back(outputPath + ".run" + std::to_string(runPaths.size()));
+				SortRun(run);
+				if (!WriteRun(run, runPaths.back()))
+				{
+					RemoveRuns(runPaths);
+					return false;
+				}
+				run.clear();
+			}
+		}
+
+		SortRun(run);
+
+		PositionRecordWriter output;
+		if (!output.Open(outputPath))
+		{
+			RemoveRuns(runPaths);
+			return false;
+		}
+
+		bool isMerged = true;
+		if (runPaths.empty())
+		{
+			for (const KeyedRecord& keyed : run)
+				output.Write(keyed.Record);
+		}
+		else
+		{
+			if (!run.empty())
+			{
+				runPaths.push_back(outputPath + ".run" + std::to_string(runPaths.size()));
+				isMerged = WriteRun(run, runPaths.back());
+			}
+
+			// Frees the memory of the last run before merging
+			std::vector<KeyedRecord>().swap(run);
+			isMerged = isMerged && MergeRuns(runPaths, output);
+			RemoveRuns(runPaths);
+		}
+
+		m_RunCount = std::max<size_t>(runPaths.size(), 1);
+		m_OutputCount = output.GetRecordCount();
+		if (!output.Close() || !isMerged)
+		{
+			std::cerr << "Could not write " << outputPath << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	void RecordDeduplicator::SortRun(std::vector<KeyedRecord>& run)
+	{
+		std::sort(run.begin(), run.end(), [](const KeyedRecord& a, const KeyedRecord& b)
+		{
+			return std::tie(a.Key, a.Index) < std::tie(b.Key, b.Index);
+		});
+
+		auto end = std::unique(run.begin(), run.end(), [](const KeyedRecord& a, const KeyedRecord& b) { return a.Key == b.Key; });
+		run.erase(end, run.end());
+	}
+
+	bool RecordDeduplicator::WriteRun(const std::vector<KeyedRecord>& run, const std::string& path)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(run.data()), (std::streamsize)(run.size() * sizeof(KeyedRecord)));
+		file.close();
+
+		if (file.fail())
+		{
+			std::cerr << "Could not write run " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool RecordDeduplicator::MergeRuns(const std::vector<std::string>& runPaths, PositionRecordWriter& output)
+	{
+		// Each run is read front to back through its own mapping
+		std::vector<MappedFile> files(runPaths.size());
+		std::vector<std::span<const KeyedRecord>> runs;
+		for (size_t i = 0; i < runPaths.size(); i++)
+		{
+			if (!files[i].Open(runPaths[i], MappedFile::Access::Sequential))
+			{
+				std::cerr << "Could not read run " << runPaths[i] << std::endl;
+				return false;
+			}
+			runs.emplace_back(reinterpret_cast<const KeyedRecord*>(files[i].GetData()), files[i].GetSize() / sizeof(KeyedRecord));
+		}
+
+		// The front record of every run, smallest key first and the first record of a key before the others
+		using Front = std::tuple<uint64_t, uint64_t, size_t>; // Key, index, run
+		std::priority_queue<Front, std::vector<Front>, std::greater<Front>> fronts;
+		std::vector<size_t> offsets(runs.size(), 0);
+		for (size_t i = 0; i < runs.size(); i++)
+			fronts.push({ runs[i][0].Key, runs[i][0].Index, i });
+
+		bool isFirst = true;
+		uint64_t lastKey = 0;
+		while (!fronts.empty())
+		{
+			auto [key, index, i] = fronts.top();
+			fronts.pop();
+
+			if (isFirst || key != lastKey)
+				output.Write(runs[i][offsets[i]].Record);
+			isFirst = false;
+			lastKey = key;
+
+			if (++offsets[i] < runs[i].size())
+				fronts.push({ runs[i][offsets[i]].Key, runs[i][offsets[i]].Index, i });
+		}
+		return true;
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Valor/Chess/PositionRecord.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Valor::Data {
+
+	// Keeps the first record of each position in a record file, telling positions apart by their Zobrist key.
+	// Records are sorted on the key in runs that fit the memory budget, and runs past the first are written
+	// next to the output and merged, so files larger than memory work. The output is in key order, which also
+	// leaves it shuffled.
+	class RecordDeduplicator
+	{
+	public:
+		explicit RecordDeduplicator(size_t memoryBytes) : m_MemoryBytes(memoryBytes) {}
+
+		// Returns false if the input can't be read or the output or a run can't be written
+		bool Run(const std::string& inputPath, const std::string& outputPath);
+
+		size_t GetInputCount() const { return m_InputCount; }
+		size_t GetOutputCount() const { return m_OutputCount; }
+		size_t GetRunCount() const { return m_RunCount; }
+
+		// Records whose position doesn't unpack, which are left out
+		size_t GetSkippedCount() const { return m_SkippedCount; }
+	private:
+		struct KeyedRecord
+		{
+			uint64_t Key;
+			uint64_t Index; // In the input, so the first record of a position can be told apart
+			PositionRecord Record;
+		};
+
+		// Sorts the run by key, keeping only the first record of each
+		static void SortRun(std::vector<KeyedRecord>& run);
+
+		bool WriteRun(const std::vector<KeyedRecord>& run, const std::string& path);
+		bool MergeRuns(const std::vector<std::string>& runPaths, PositionRecordWriter& output);
+	private:
+		size_t m_MemoryBytes;
+
+		size_t m_InputCount = 0;
+		size_t m_OutputCount = 0;
+		size_t m_RunCount = 0;
+		size_t m_SkippedCount = 0;
+	};
+
+}
@@ -0,0 +1,132 @@
+#include "RecordPacker.h"
+
+#include "Valor/Chess/EPDReader.h"
+#include "Valor/Chess/PGNReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <iostream>
+#include <optional>
+
+namespace Valor::Data {
+
+	bool RecordPacker::Pack(const std::string& inputPath, const std::string& outputPath)
+	{
+		if (!m_Output.Open(outputPath))
+			return false;
+
+		m_Blocks.assign(m_ThreadCount, {});
+		m_GameRecords.assign(m_ThreadCount, {});
+		m_SkippedCount = 0;
+
+		bool isRead = inputPath.ends_with(".pgn") ? PackPGN(inputPath) : PackEPD(inputPath);
+		for (std::vector<PositionRecord>& block : m_Blocks)
+			WriteBlock(block);
+
+		if (!m_Output.Close())
+		{
+			std::cerr << "Could not write " << outputPath << std::endl;
+			return false;
+		}
+		return isRead;
+	}
+
+	bool RecordPacker::PackEPD(const std::string& path)
+	{
+		EPDFile file;
+		if (!file.Open(path))
+			return false;
+
+		std::atomic<size_t> skippedCount = 0;
+		size_t skippedLines = file.ReadParallel(m_ThreadCount, [&](const EPDRecord& epd, unsigned thread)
+		{
+			PositionRecord record;
+			if (!epd.Position.ToPacked(record.Position))
+			{
+				skippedCount++;
+				return;
+			}
+
+			int result = epd.GetResult();
+			if (result >= 0)
+				record.Result = (uint8_t)result;
+
+			// EPD scores are from the side to move's point of view
+			int score;
+			std::optional<EPDOperation> ce = epd.FindOperation("ce");
+			if (ce && std::from_chars(ce->Operands.data(), ce->Operands.data() + ce->Operands.size(), score).ec == std::errc())
+			{
+				score = std::clamp(score, -INT16_MAX, (int)INT16_MAX);
+				record.Score = (int16_t)(epd.Position.IsWhiteTurn() ? score : -score);
+			}
+
+			if (std::optional<EPDOperation> bm = epd.FindOperation("bm"))
+			{
+				std::string_view san = bm->Operands.substr(0, bm->Operands.find(' '));
+				record.BestMove = PositionRecord::PackMove(epd.Position.ParseSAN(san));
+			}
+
+			std::vector<PositionRecord>& block = m_Blocks[thread];
+			block.push_back(record);
+			if (block.size() == BlockSize)
+				WriteBlock(block);
+		});
+
+		m_SkippedCount = skippedLines + skippedCount;
+		return true;
+	}
+
+	bool RecordPacker::PackPGN(const std::string& path)
+	{
+		PGNFile file;
+		if (!file.Open(path))
+			return false;
+
+		std::atomic<size_t> skippedCount = 0;
+		file.ReadParallel(m_ThreadCount, [&](const PGNGame& game, unsigned thread)
+		{
+			uint8_t result = PositionRecord::NoResult;
+			std::optional<std::string_view> resultTag = game.FindHeader("Result");
+			if (resultTag == "1-0") result = 2;
+			else if (resultTag == "1/2-1/2") result = 1;
+			else if (resultTag == "0-1") result = 0;
+
+			std::vector<PositionRecord>& gameRecords = m_GameRecords[thread];
+			gameRecords.clear();
+			bool isReplayed = game.Replay([&](const Board& position, Move move)
+			{
+				PositionRecord record;
+				if (!position.ToPacked(record.Position))
+					return;
+
+				record.BestMove = PositionRecord::PackMove(move);
+				record.Result = result;
+				gameRecords.push_back(record);
+			});
+
+			if (!isReplayed)
+			{
+				skippedCount++;
+				return;
+			}
+
+			std::vector<PositionRecord>& block = m_Blocks[thread];
+			block.insert(block.end(), gameRecords.begin(), gameRecords.end());
+			if (block.size() >= BlockSize)
+				WriteBlock(block);
+		});
+
+		m_SkippedCount = skippedCount;
+		return true;
+	}
+
+	void RecordPacker::WriteBlock(std::vector<PositionRecord>& block)
+	{
+		std::scoped_lock lock(m_OutputMutex);
+		for (const PositionRecord& record : block)
+			m_Output.Write(record);
+		block.clear();
+	}
+
+}
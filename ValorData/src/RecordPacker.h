@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Valor/Chess/PositionRecord.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Valor::Data {
+
+	// Converts EPD or PGN text into a record file, reading on several threads. Records from different threads
+	// are interleaved in the output.
+	class RecordPacker
+	{
+	public:
+		explicit RecordPacker(unsigned threadCount) : m_ThreadCount(std::max(threadCount, 1u)) {}
+
+		// An EPD or FEN line gives its position with its result, its `ce` score and the first move of its `bm`,
+		// as far as it has them. A PGN game (.pgn) gives the position before each move, with the game's result
+		// and the move played. Returns false if either file can't be opened or written.
+		bool Pack(const std::string& inputPath, const std::string& outputPath);
+
+		size_t GetRecordCount() const { return m_Output.GetRecordCount(); }
+
+		// Lines that don't parse, or games with a move that doesn't. None of such a game's positions are kept.
+		size_t GetSkippedCount() const { return m_SkippedCount; }
+	private:
+		bool PackEPD(const std::string& path);
+		bool PackPGN(const std::string& path);
+
+		// Writes out a thread's block of records, and empties it
+		void WriteBlock(std::vector<PositionRecord>& block);
+	private:
+		constexpr static size_t BlockSize = 1 << 12; // Records
+	private:
+		unsigned m_ThreadCount;
+		std::vector<std::vector<PositionRecord>> m_Blocks; // One for each thread
+		std::vector<std::vector<PositionRecord>> m_GameRecords; // Each thread's current game, added once it replays
+
+		std::mutex m_OutputMutex;
+		PositionRecordWriter m_Output;
+		size_t m_SkippedCount = 0;
+	};
+
+}
@@ -0,0 +1,103 @@
+#include "TexelTuner.h"
+#include "TuneDataset.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+// Tuned parameters are written out this often during a run, so a stopped run keeps most of its progress
+constexpr int CheckpointInterval = 10;
+
+static double SecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void PrintUsage()
+{
+	std::cout << "Usage: ValorTune <dataset> [options]\n"
+		<< "  --epochs <n>     Passes over the dataset (100)\n"
+		<< "  --batch <n>      Positions per step (16384)\n"
+		<< "  --rate <x>       Learning rate in centipawns (1.0)\n"
+		<< "  --threads <n>    Worker threads (all cores)\n"
+		<< "  --output <path>  Tuned EvalParameters.h (EvalParameters.h)\n";
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string datasetPath = argv[1];
+	std::string outputPath = "EvalParameters.h";
+	int epochs = 100;
+
+	Valor::Tune::TuneOptions options;
+	options.ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		std::string option = argv[i];
+		std::string value = argv[i + 1];
+
+		if (option == "--epochs")
+			epochs = std::stoi(value);
+		else if (option == "--batch")
+			options.BatchSize = std::stoull(value);
+		else if (option == "--rate")
+			options.LearningRate = std::stod(value);
+		else if (option == "--threads")
+			options.ThreadCount = (unsigned)std::stoul(value);
+		else if (option == "--output")
+			outputPath = value;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	Clock::time_point loadStart = Clock::now();
+	Valor::Tune::TuneDataset dataset;
+	if (!dataset.Load(datasetPath, options.ThreadCount))
+		return 1;
+
+	size_t positionCount = dataset.GetPositions().size();
+	double loadTime = SecondsSince(loadStart);
+	std::cout << "Loaded " << positionCount << " positions in " << loadTime << " s ("
+		<< (size_t)(positionCount / loadTime) << " positions/s), skipped " << dataset.GetSkippedLines() << " lines" << std::endl;
+	if (positionCount == 0)
+		return 1;
+
+	Valor::Tune::EvalParameterVector parameters = Valor::Tune::EvalParameterVector::FromEngine();
+	Valor::Tune::TexelTuner tuner(dataset, options);
+
+	double scale = tuner.FitScale(parameters);
+	std::cout << "Sigmoid scale " << scale << ", loss " << tuner.ComputeLoss(parameters) << std::endl;
+
+	for (int epoch = 1; epoch <= epochs; epoch++)
+	{
+		Clock::time_point epochStart = Clock::now();
+		double loss = tuner.RunEpoch(parameters);
+		double epochTime = SecondsSince(epochStart);
+
+		std::cout << "Epoch " << epoch << ": loss " << loss << ", "
+			<< (size_t)(positionCount / epochTime) << " positions/s" << std::endl;
+
+		if (epoch % CheckpointInterval == 0 && epoch != epochs)
+			parameters.WriteHeader(outputPath);
+	}
+
+	std::cout << "Final loss " << tuner.ComputeLoss(parameters) << std::endl;
+	if (!parameters.WriteHeader(outputPath))
+		return 1;
+
+	std::cout << "Tuned parameters written to " << outputPath << std::endl;
+}
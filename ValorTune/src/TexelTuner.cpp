@@ -0,0 +1,296 @@
+#include "TexelTuner.h"
+
+#include "Valor/Engine/Evaluator/EvalParameters.h"
+
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace Valor::Tune {
+
+	constexpr const char* PieceNames[6] = { "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+
+	// Adam's decay rates for the moment estimates
+	constexpr double MomentumDecay = 0.9;
+	constexpr double VelocityDecay = 0.999;
+
+	EvalParameterVector EvalParameterVector::FromEngine()
+	{
+		EvalParameterVector parameters;
+		for (int type = 0; type < 6; type++)
+		{
+			int value = 2 * PieceValueTerm(type);
+			parameters.Weights[value] = Engine::EvalParameters::PieceValues[type].Midgame;
+			parameters.Weights[value + 1] = Engine::EvalParameters::PieceValues[type].Endgame;
+
+			for (int index = 0; index < 64; index++)
+			{
+				int square = 2 * TableTerm(type, index);
+				parameters.Weights[square] = Engine::EvalParameters::MidgameTables[type][index];
+				parameters.Weights[square + 1] = Engine::EvalParameters::EndgameTables[type][index];
+			}
+		}
+		return parameters;
+	}
+
+	bool EvalParameterVector::WriteHeader(const std::string& path) const
+	{
+		std::ofstream header(path);
+		if (!header.is_open())
+		{
+			std::cerr << "Failed to open " << path << " for writing" << std::endl;
+			return false;
+		}
+
+		auto weight = [this](int term, int stage) { return (int)std::lround(Weights[2 * term + stage]); };
+
+		header << "#pragma once\n\n";
+		header << "#include \"Valor/Engine/Evaluator/PieceSquareTables.h\"\n\n";
+		header << "// The evaluation terms ValorTune tunes. It writes its results back out in this file's format.\n\n";
+		header << "namespace Valor::Engine::EvalParameters {\n\n";
+
+		header << "\t// Piece values by piece type, midgame and endgame. Only the evaluation uses these; move ordering and\n";
+		header << "\t// pruning keep the fixed values in Evaluator.h.\n";
+		header << "\tconstexpr TaperedScore PieceValues[6] = {\n";
+		for (int type = 0; type < 6; type++)
+		{
+			header << "\t\t{ " << weight(PieceValueTerm(type), 0) << ", " << weight(PieceValueTerm(type), 1)
+				<< " }, // " << PieceNames[type] << '\n';
+		}
+		header << "\t};\n\n";
+
+		header << "\t// Piece-square bonuses by piece type, from White's point of view with rank 8 on top\n";
+		for (int stage = 0; stage < 2; stage++)
+		{
+			header << "\tconstexpr int " << (stage == 0 ? "MidgameTables" : "EndgameTables") << "[6][64] = {\n";
+			for (int type = 0; type < 6; type++)
+			{
+				header << "\t\t// " << PieceNames[type] << "\n\t\t{\n";
+				for (int rank = 0; rank < 8; rank++)
+				{
+					header << "\t\t\t";
+					for (int file = 0; file < 8; file++)
+						header << std::setw(3) << weight(TableTerm(type, rank * 8 + file), stage) << (file < 7 ? ", " : ",\n");
+				}
+				header << "\t\t},\n";
+			}
+			header << "\t};\n" << (stage == 0 ? "\n" : "");
+		}
+
+		header << "\n}\n";
+		return header.good();
+	}
+
+	TexelTuner::TexelTuner(const TuneDataset& dataset, const TuneOptions& options)
+		: m_Dataset(dataset), m_Options(options)
+	{
+		m_Options.ThreadCount = std::max(m_Options.ThreadCount, 1u);
+		m_Options.BatchSize = std::max<size_t>(m_Options.BatchSize, 1);
+
+		m_Gradients.assign(m_Options.ThreadCount, std::vector<double>(2 * EvalParameterVector::TermCount));
+		m_Momentum.assign(2 * EvalParameterVector::TermCount, 0.0);
+		m_Velocity.assign(2 * EvalParameterVector::TermCount, 0.0);
+	}
+
+	double TexelTuner::FitScale(const EvalParameterVector& parameters)
+	{
+		// Scan coarse to fine around the best scale so far, the loss has a single minimum in it
+		double best = 1.0;
+		double bestLoss = std::numeric_limits<double>::max();
+		for (double step = 0.1; step >= 0.001; step /= 10)
+		{
+			double center = best;
+			for (int i = -10; i <= 10; i++)
+			{
+				m_Scale = center + i * step;
+				if (m_Scale <= 0.0)
+					continue;
+
+				double loss = ComputeLoss(parameters);
+				if (loss < bestLoss)
+				{
+					bestLoss = loss;
+					best = m_Scale;
+				}
+			}
+		}
+
+		m_Scale = best;
+		return m_Scale;
+	}
+
+	double TexelTuner::ComputeLoss(const EvalParameterVector& parameters) const
+	{
+		const std::vector<TunePosition>& positions = m_Dataset.GetPositions();
+		if (positions.empty())
+			return 0.0;
+
+		std::vector<double> losses(m_Options.ThreadCount);
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < m_Options.ThreadCount; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				size_t begin = positions.size() * i / m_Options.ThreadCount;
+				size_t end = positions.size() * (i + 1) / m_Options.ThreadCount;
+
+				double loss = 0.0;
+				for (size_t j = begin; j < end; j++)
+				{
+					double error = positions[j].Result * 0.5 - Sigmoid(Evaluate(positions[j], parameters.Weights.data()));
+					loss += error * error;
+				}
+				losses[i] = loss;
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return std::accumulate(losses.begin(), losses.end(), 0.0) / positions.size();
+	}
+
+	double TexelTuner::RunEpoch(EvalParameterVector& parameters)
+	{
+		size_t positionCount = m_Dataset.GetPositions().size();
+		size_t batchCount = (positionCount + m_Options.BatchSize - 1) / m_Options.BatchSize;
+		if (batchCount == 0)
+			return 0.0;
+
+		// Batches stay contiguous for the caches, only their order is shuffled
+		std::vector<size_t> batches(batchCount);
+		std::iota(batches.begin(), batches.end(), 0);
+		std::shuffle(batches.begin(), batches.end(), std::mt19937_64(std::random_device()()));
+
+		unsigned threadCount = m_Options.ThreadCount;
+		std::vector<double> losses(threadCount);
+		double totalLoss = 0.0;
+		size_t batchIndex = 0;
+
+		// Runs once every thread has its share of a batch, before any of them moves on to the next
+		auto onBatchDone = [&]() noexcept
+		{
+			for (unsigned i = 1; i < threadCount; i++)
+			{
+				for (size_t j = 0; j < m_Gradients[0].size(); j++)
+					m_Gradients[0][j] += m_Gradients[i][j];
+				std::fill(m_Gradients[i].begin(), m_Gradients[i].end(), 0.0);
+			}
+
+			ApplyStep(parameters);
+			totalLoss += std::accumulate(losses.begin(), losses.end(), 0.0);
+			batchIndex++;
+		};
+		std::barrier sync((std::ptrdiff_t)threadCount, onBatchDone);
+
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				while (batchIndex < batchCount)
+				{
+					size_t batchBegin = batches[batchIndex] * m_Options.BatchSize;
+					size_t batchSize = std::min(m_Options.BatchSize, positionCount - batchBegin);
+
+					size_t begin = batchBegin + batchSize * i / threadCount;
+					size_t end = batchBegin + batchSize * (i + 1) / threadCount;
+					losses[i] = AccumulateGradient(begin, end, parameters.Weights.data(), 1.0 / batchSize, m_Gradients[i]);
+					sync.arrive_and_wait();
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return totalLoss / positionCount;
+	}
+
+	double TexelTuner::Evaluate(const TunePosition& position, const double* weights) const
+	{
+		double midgame = 0.0, endgame = 0.0;
+		const uint16_t* pieces = m_Dataset.GetPieces(position);
+		for (int i = 0; i < position.PieceCount; i++)
+		{
+			int type = TuneDataset::GetType(pieces[i]);
+			int value = 2 * EvalParameterVector::PieceValueTerm(type);
+			int square = 2 * EvalParameterVector::TableTerm(type, TuneDataset::GetIndex(pieces[i]));
+
+			double sign = TuneDataset::GetColor(pieces[i]) == 0 ? 1.0 : -1.0;
+			midgame += sign * (weights[value] + weights[square]);
+			endgame += sign * (weights[value + 1] + weights[square + 1]);
+		}
+
+		return (midgame * position.Phase + endgame * (Engine::MaxGamePhase - position.Phase)) / Engine::MaxGamePhase
+			+ position.FixedScore;
+	}
+
+	double TexelTuner::Sigmoid(double score) const
+	{
+		// Expected result for White, where 400 centipawns make ten to one odds at a scale of 1
+		return 1.0 / (1.0 + std::pow(10.0, -m_Scale * score / 400.0));
+	}
+
+	double TexelTuner::AccumulateGradient(size_t begin, size_t end, const double* weights, double weight, std::vector<double>& gradient) const
+	{
+		const std::vector<TunePosition>& positions = m_Dataset.GetPositions();
+		const double sigmoidSlope = m_Scale * std::log(10.0) / 400.0;
+
+		double loss = 0.0;
+		for (size_t i = begin; i < end; i++)
+		{
+			const TunePosition& position = positions[i];
+			double expected = Sigmoid(Evaluate(position, weights));
+			double error = expected - position.Result * 0.5;
+			loss += error * error;
+
+			// Derivative of the squared error by the evaluation, split between the midgame and endgame weights
+			double slope = 2.0 * error * expected * (1.0 - expected) * sigmoidSlope * weight;
+			double midgameSlope = slope * position.Phase / Engine::MaxGamePhase;
+			double endgameSlope = slope - midgameSlope;
+
+			const uint16_t* pieces = m_Dataset.GetPieces(position);
+			for (int j = 0; j < position.PieceCount; j++)
+			{
+				int type = TuneDataset::GetType(pieces[j]);
+				int value = 2 * EvalParameterVector::PieceValueTerm(type);
+				int square = 2 * EvalParameterVector::TableTerm(type, TuneDataset::GetIndex(pieces[j]));
+
+				double sign = TuneDataset::GetColor(pieces[j]) == 0 ? 1.0 : -1.0;
+				gradient[value] += sign * midgameSlope;
+				gradient[value + 1] += sign * endgameSlope;
+				gradient[square] += sign * midgameSlope;
+				gradient[square + 1] += sign * endgameSlope;
+			}
+		}
+		return loss;
+	}
+
+	void TexelTuner::ApplyStep(EvalParameterVector& parameters)
+	{
+		m_Step++;
+		double momentumCorrection = 1.0 - std::pow(MomentumDecay, m_Step);
+		double velocityCorrection = 1.0 - std::pow(VelocityDecay, m_Step);
+
+		std::vector<double>& gradient = m_Gradients[0];
+		for (size_t i = 0; i < gradient.size(); i++)
+		{
+			m_Momentum[i] = MomentumDecay * m_Momentum[i] + (1.0 - MomentumDecay) * gradient[i];
+			m_Velocity[i] = VelocityDecay * m_Velocity[i] + (1.0 - VelocityDecay) * gradient[i] * gradient[i];
+
+			double momentum = m_Momentum[i] / momentumCorrection;
+			double velocity = m_Velocity[i] / velocityCorrection;
+			parameters.Weights[i] -= m_Options.LearningRate * momentum / (std::sqrt(velocity) + 1e-8);
+		}
+		std::fill(gradient.begin(), gradient.end(), 0.0);
+	}
+
+}
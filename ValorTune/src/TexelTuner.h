@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TuneDataset.h"
+
+#include <string>
+#include <vector>
+
+namespace Valor::Tune {
+
+	// The terms of EvalParameters.h as one vector: the six piece values, then the 64 squares of each piece
+	// type's table. Every term has a midgame weight followed by an endgame weight.
+	struct EvalParameterVector
+	{
+		constexpr static int TableOffset = 6;
+		constexpr static int TermCount = TableOffset + 6 * 64;
+
+		std::vector<double> Weights = std::vector<double>(2 * TermCount);
+
+		static int PieceValueTerm(int type) { return type; }
+		static int TableTerm(int type, int index) { return TableOffset + type * 64 + index; }
+
+		// The values the engine is built with
+		static EvalParameterVector FromEngine();
+
+		// Writes the weights, rounded, as a replacement for EvalParameters.h. Returns false if the file can't be written.
+		bool WriteHeader(const std::string& path) const;
+	};
+
+	struct TuneOptions
+	{
+		size_t BatchSize = 16384;
+		double LearningRate = 1.0;
+		unsigned ThreadCount = 1;
+	};
+
+	// Texel tuning: fits the weights so a sigmoid of the evaluation predicts the game results, minimizing the
+	// mean squared error with Adam over mini-batches. Each batch is split across the threads, which reduce
+	// their gradients into one step.
+	class TexelTuner
+	{
+	public:
+		TexelTuner(const TuneDataset& dataset, const TuneOptions& options);
+
+		// Finds the sigmoid scale that fits `parameters` best, and keeps using it
+		double FitScale(const EvalParameterVector& parameters);
+		double GetScale() const { return m_Scale; }
+
+		// Mean squared error over the whole dataset
+		double ComputeLoss(const EvalParameterVector& parameters) const;
+
+		// One pass over the dataset, in batches taken in a random order. Returns the mean loss of the batches,
+		// each measured before its step.
+		double RunEpoch(EvalParameterVector& parameters);
+	private:
+		double Evaluate(const TunePosition& position, const double* weights) const;
+		double Sigmoid(double score) const;
+
+		// Adds the gradient of the loss over positions [begin, end) to `gradient`, scaled by `weight`, and
+		// returns the summed loss
+		double AccumulateGradient(size_t begin, size_t end, const double* weights, double weight, std::vector<double>& gradient) const;
+
+		void ApplyStep(EvalParameterVector& parameters);
+	private:
+		const TuneDataset& m_Dataset;
+		TuneOptions m_Options;
+		double m_Scale = 1.0;
+
+		// One gradient per thread, summed into the first before each step
+		std::vector<std::vector<double>> m_Gradients;
+
+		// Adam's moment estimates
+		std::vector<double> m_Momentum;
+		std::vector<double> m_Velocity;
+		int m_Step = 0;
+	};
+
+}
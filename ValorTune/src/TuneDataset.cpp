@@ -0,0 +1,126 @@
+#include "TuneDataset.h"
+
+#include "Valor/Chess/PositionRecord.h"
+#include "Valor/Engine/Evaluator/PawnHashTable.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <span>
+#include <thread>
+
+namespace Valor::Tune {
+
+	bool TuneDataset::Load(const std::string& path, unsigned threadCount)
+	{
+		if (path.ends_with(".bin"))
+			return LoadRecords(path, threadCount);
+
+		EPDFile file;
+		if (!file.Open(path))
+			return false;
+
+		// Each thread parses a range of whole lines into its own dataset, scoring with its own evaluator
+		threadCount = std::max(threadCount, 1u);
+		std::vector<TuneDataset> parts(threadCount);
+		std::vector<Engine::PawnHashTable> pawnTables(threadCount);
+		std::vector<Engine::PositionalEvaluator> evaluators;
+		for (Engine::PawnHashTable& pawnTable : pawnTables)
+			evaluators.emplace_back(&pawnTable);
+
+		m_SkippedLines = file.ReadParallel(threadCount, [&](const EPDRecord& record, unsigned thread)
+		{
+			int result = record.GetResult();
+			if (result >= 0)
+				parts[thread].AddPosition(record.Position, result, evaluators[thread]);
+			else
+				parts[thread].m_SkippedLines++;
+		});
+
+		Merge(parts);
+		return true;
+	}
+
+	bool TuneDataset::LoadRecords(const std::string& path, unsigned threadCount)
+	{
+		PositionRecordFile file;
+		if (!file.Open(path))
+			return false;
+
+		// Each thread unpacks an equal share of the records into its own dataset
+		std::span<const PositionRecord> records = file.GetRecords();
+		threadCount = std::max(threadCount, 1u);
+		std::vector<TuneDataset> parts(threadCount);
+
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back([&, i]()
+			{
+				Engine::PawnHashTable pawnTable;
+				Engine::PositionalEvaluator evaluator(&pawnTable);
+
+				size_t begin = records.size() * i / threadCount;
+				size_t end = records.size() * (i + 1) / threadCount;
+
+				Board board;
+				for (const PositionRecord& record : records.subspan(begin, end - begin))
+				{
+					if (record.Result <= 2 && Board::FromPacked(record.Position, board))
+						parts[i].AddPosition(board, record.Result, evaluator);
+					else
+						parts[i].m_SkippedLines++;
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		Merge(parts);
+		return true;
+	}
+
+	void TuneDataset::Merge(const std::vector<TuneDataset>& parts)
+	{
+		for (const TuneDataset& part : parts)
+		{
+			uint32_t pieceOffset = (uint32_t)m_Pieces.size();
+			for (TunePosition position : part.m_Positions)
+			{
+				position.FirstPiece += pieceOffset;
+				m_Positions.push_back(position);
+			}
+			m_Pieces.insert(m_Pieces.end(), part.m_Pieces.begin(), part.m_Pieces.end());
+			m_SkippedLines += part.m_SkippedLines;
+		}
+	}
+
+	void TuneDataset::AddPosition(const Board& board, int result, Engine::PositionalEvaluator& evaluator)
+	{
+		TunePosition position;
+		position.FirstPiece = (uint32_t)m_Pieces.size();
+		position.Phase = (uint8_t)std::clamp(board.GetGamePhase(), 0, Engine::MaxGamePhase);
+		position.Result = (uint8_t)result;
+
+		uint64_t occupied = board.Occupied();
+		while (occupied)
+		{
+			int square = std::countr_zero(occupied);
+			occupied &= occupied - 1;
+
+			Piece piece = board.GetPiece(Tile((uint8_t)square));
+			int color = (int)piece.Color;
+			m_Pieces.push_back(PackPiece(color, (int)piece.Type, color == 0 ? square ^ 56 : square));
+		}
+		position.PieceCount = (uint8_t)(m_Pieces.size() - position.FirstPiece);
+
+		// Everything the tuned material and piece-square terms don't cover
+		int tuned = board.GetMaterial() + board.GetPieceSquareScore().Blend(board.GetGamePhase());
+		int fixed = evaluator.Evaluate(board) - tuned;
+		position.FixedScore = (int16_t)std::clamp(fixed, (int)std::numeric_limits<int16_t>::min(), (int)std::numeric_limits<int16_t>::max());
+
+		m_Positions.push_back(position);
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Valor/Chess/EPDReader.h"
+#include "Valor/Engine/Evaluator/Evaluator.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Valor::Tune {
+
+	// A labeled position reduced to what the tuned terms need. Its pieces are stored in the dataset's piece
+	// list, each as `PackPiece` packs it.
+	struct TunePosition
+	{
+		uint32_t FirstPiece;
+		int16_t FixedScore; // The terms that aren't tuned, White's point of view
+		uint8_t PieceCount;
+		uint8_t Phase;
+		uint8_t Result; // 0 for a Black win, 1 for a draw, 2 for a White win
+	};
+
+	class TuneDataset
+	{
+	public:
+		// Lines of a FEN or EPD file, each with a result after the position as "1-0", "0-1" or "1/2-1/2", or as
+		// [1.0], [0.5] or [0.0], or the records of a .bin record file. Read on `threadCount` threads. Returns false
+		// if the file can't be read; positions without a result are skipped.
+		bool Load(const std::string& path, unsigned threadCount);
+
+		const std::vector<TunePosition>& GetPositions() const { return m_Positions; }
+		const uint16_t* GetPieces(const TunePosition& position) const { return m_Pieces.data() + position.FirstPiece; }
+
+		size_t GetSkippedLines() const { return m_SkippedLines; }
+
+		// Color, piece type and the square as it indexes the White-relative tables
+		static uint16_t PackPiece(int color, int type, int index) { return (uint16_t)(color << 9 | type << 6 | index); }
+		static int GetColor(uint16_t piece) { return piece >> 9; }
+		static int GetType(uint16_t piece) { return (piece >> 6) & 7; }
+		static int GetIndex(uint16_t piece) { return piece & 63; }
+	private:
+		bool LoadRecords(const std::string& path, unsigned threadCount);
+
+		// Adds the position, scoring the untuned terms with `evaluator`
+		void AddPosition(const Board& board, int result, Engine::PositionalEvaluator& evaluator);
+
+		// Appends the positions of datasets loaded by separate threads
+		void Merge(const std::vector<TuneDataset>& parts);
+	private:
+		std::vector<TunePosition> m_Positions;
+		std::vector<uint16_t> m_Pieces;
+		size_t m_SkippedLines = 0;
+	};
+
+}
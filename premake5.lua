@@ -30,5 +30,7 @@ group ""
 
 group "Tools"
 	include "ValorCLI"
+	include "ValorTune"
+	include "ValorData"
 	include "MagicBitboardGenerator"
 group ""